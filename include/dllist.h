@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #ifdef _DEBUG
@@ -12,18 +13,135 @@
 
 #endif // _DEBUG
 
-#define DLLIST_MAKE(varname) \
-    dllist_t varname = {     \
-        .data     = NULL,    \
-        .next     = NULL,    \
-        .prev     = NULL,    \
-        .free     = 0,       \
-        .cpcty    = 0,       \
-        .size     = 0        \
-    }
-
 typedef int dllist_data_t;
 
+// Links are stored as dllist_idx_t. With DLLIST_IDX32 they are 32-bit,
+// which limits capacity to INT32_MAX slots but shrinks a node of int
+// payload from 20 to 12 bytes.
+
+#ifdef DLLIST_IDX32
+typedef int32_t dllist_idx_t;
+#else // DLLIST_IDX32
+typedef ssize_t dllist_idx_t;
+#endif // DLLIST_IDX32
+
+// Node storage layout is chosen at build time:
+//   default   - three parallel arrays data[], next[], prev[] (SoA)
+//   DLLIST_AOS - one array of nodes, value and both links of a node
+//                share a cache line (AoS)
+// Use DLLIST_DATA/DLLIST_NEXT/DLLIST_PREV to stay layout-agnostic.
+
+#ifdef DLLIST_AOS
+
+    #define DLLIST_DATA(dllist, ind) ((dllist)->node[ind].data)
+    #define DLLIST_NEXT(dllist, ind) ((dllist)->node[ind].next)
+    #define DLLIST_PREV(dllist, ind) ((dllist)->node[ind].prev)
+
+    #define DLLIST_INIT          \
+        {                        \
+            .node     = NULL,    \
+            .free     = 0,       \
+            .hwm      = 0,       \
+            .cpcty    = 0,       \
+            .size     = 0,       \
+            .is_linear = 0,      \
+            .hash     = NULL,    \
+            .order    = NULL,    \
+            .compact  = NULL,    \
+            .compact_lo = 0,     \
+            .compact_step = 0,   \
+            .freemap  = NULL,    \
+            .freemap_lo = 0,     \
+            .mapped   = 0,       \
+            .fd       = -1,      \
+            .alloc    = NULL,    \
+            .max_cpcty = 0,      \
+            .growth   = {NULL, NULL, 0, 0} \
+        }
+
+#else // DLLIST_AOS
+
+    #define DLLIST_DATA(dllist, ind) ((dllist)->data[ind])
+    #define DLLIST_NEXT(dllist, ind) ((dllist)->next[ind])
+    #define DLLIST_PREV(dllist, ind) ((dllist)->prev[ind])
+
+    #define DLLIST_INIT          \
+        {                        \
+            .data     = NULL,    \
+            .next     = NULL,    \
+            .prev     = NULL,    \
+            .free     = 0,       \
+            .hwm      = 0,       \
+            .cpcty    = 0,       \
+            .size     = 0,       \
+            .is_linear = 0,      \
+            .hash     = NULL,    \
+            .order    = NULL,    \
+            .compact  = NULL,    \
+            .compact_lo = 0,     \
+            .compact_step = 0,   \
+            .freemap  = NULL,    \
+            .freemap_lo = 0,     \
+            .mapped   = 0,       \
+            .fd       = -1,      \
+            .alloc    = NULL,    \
+            .max_cpcty = 0,      \
+            .growth   = {NULL, NULL, 0, 0} \
+        }
+
+#endif // DLLIST_AOS
+
+#define DLLIST_MAKE(varname) dllist_t varname = DLLIST_INIT
+
+typedef int (*dllist_pred_t)(dllist_data_t val, void* ctx);
+
+// negative, zero or positive as lhs sorts before, with or after rhs
+typedef int (*dllist_cmp_t)(dllist_data_t lhs, dllist_data_t rhs, void* ctx);
+
+typedef void (*dllist_visit_t)(dllist_data_t* val, void* ctx);
+
+typedef int64_t (*dllist_fold_t)(int64_t acc, dllist_data_t val, void* ctx);
+
+typedef int64_t (*dllist_combine_t)(int64_t lhs, int64_t rhs, void* ctx);
+
+// Order the parallel walks hand elements out in. Within one worker's 
+// share elements come in that order; partial results are combined in 
+// it, so DLLIST_WALK_LIST only needs an associative combine
+typedef enum dllist_walk_t
+{
+    DLLIST_WALK_SLOTS,   // slot order over data[], skipping free slots
+    DLLIST_WALK_LIST     // list order
+} dllist_walk_t;
+
+// capacity a full list of cpcty slots grows to; anything below min_cpcty 
+// is raised to it
+typedef ssize_t (*dllist_grow_t)(ssize_t cpcty, ssize_t min_cpcty, void* ctx);
+
+// How a full list grows: by grow if it is set, else by step slots if 
+// that is, else by factor. All zero doubles the capacity, or adds a 
+// segment to a list with max_cpcty
+typedef struct dllist_growth_t
+{
+    dllist_grow_t grow;
+    void*         ctx;
+
+    ssize_t step;
+    double  factor;   // 0 or over 1
+
+} dllist_growth_t;
+
+// value to slot index, allocated by dllist_hash_enable
+typedef struct dllist_hash_t dllist_hash_t;
+
+// position to slot index, allocated by dllist_order_enable
+typedef struct dllist_order_t dllist_order_t;
+
+// worker threads for the bulk operations, see dllist_pool.h
+typedef struct dllist_pool_t dllist_pool_t;
+
+// node block allocator, see dllist_alloc.h
+typedef struct dllist_alloc_t dllist_alloc_t;
+
 typedef enum dllist_err_t
 {
     DLLIST_NONE,
@@ -36,33 +154,175 @@ typedef enum dllist_err_t
     DLLIST_BAD_LINK,
     DLLIST_BAD_SIZE,
     DLLIST_BAD_CPCTY,
-    DLLIST_SIZE_EXCEED_CPCTY
+    DLLIST_SIZE_EXCEED_CPCTY,
+    DLLIST_CPCTY_OVERFLOW,
+    DLLIST_BAD_HWM,
+    DLLIST_BAD_LINEAR,
+    DLLIST_BAD_HASH,
+    DLLIST_BAD_ORDER,
+    DLLIST_BAD_HOLE,
+    DLLIST_FILE_FAIL,
+    DLLIST_BAD_FILE
 } dllist_err_t;
 
+#ifdef DLLIST_AOS
+
+typedef struct dllist_node_t
+{
+    dllist_data_t data;
+
+    dllist_idx_t next;
+    dllist_idx_t prev;
+
+} dllist_node_t;
+
+#endif // DLLIST_AOS
+
 typedef struct dllist_t
 {
+#ifdef DLLIST_AOS
+    dllist_node_t* node;
+#else // DLLIST_AOS
+    // all three arrays are carved out of one allocation starting at next
     dllist_data_t* data;
     
-    ssize_t* next;
-    ssize_t* prev;
+    dllist_idx_t* next;
+    dllist_idx_t* prev;
+#endif // DLLIST_AOS
 
     ssize_t free;
+    ssize_t hwm;   // slots from hwm to cpcty have never been used
 
     ssize_t cpcty;
     ssize_t size;
 
+    // slot i holds the i-th element, set by dllist_linearize and kept 
+    // by appends to and deletes from the tail
+    int is_linear;
+
+    // NULL unless dllist_hash_enable was called
+    dllist_hash_t* hash;
+
+    // NULL unless dllist_order_enable was called
+    dllist_order_t* order;
+
+    // Holes taken off the free list by a compaction cycle, one bit per 
+    // slot; NULL between cycles. Those below compact_lo are filled
+    uint64_t* compact;
+    ssize_t compact_lo;
+
+    // Nodes moved after every delete, set by dllist_auto_compact; a cycle 
+    // starts once a quarter of the slots below hwm are holes and runs 
+    // until it ends. 0 leaves compaction to dllist_compact
+    ssize_t compact_step;
+
+    // Free slots, one bit per slot, in place of the free list once 
+    // dllist_near_enable was called; none are below freemap_lo
+    uint64_t* freemap;
+    ssize_t freemap_lo;
+
+    // bytes of the file mapping the node block lies in after 
+    // dllist_load_mmap or dllist_ctor_file, 0 while it is on the heap
+    size_t mapped;
+
+    // the file behind a dllist_ctor_file list, -1 for any other
+    int fd;
+
+    // NULL for malloc/realloc/free
+    const dllist_alloc_t* alloc;
+
+    // slots of address space held for the node block, which then grows 
+    // in place and never moves; 0 while it is moved by reallocation
+    ssize_t max_cpcty;
+
+    dllist_growth_t growth;
+
 } dllist_t;
 
+// What dllist_ctor_ex sets up a list with
+typedef struct dllist_config_t
+{
+    ssize_t init_cpcty;   // 0 for the smallest capacity
+    char* log_filename;
+
+    // NULL for malloc/realloc/free, otherwise must outlive the list
+    const dllist_alloc_t* alloc;
+
+    // Nonzero to hold address space for this many slots up front and 
+    // commit it a segment at a time, so that no insert copies the list; 
+    // the capacity never goes past it and alloc is not used
+    ssize_t max_cpcty;
+
+    dllist_growth_t growth;   // all zero for the default
+
+} dllist_config_t;
+
+// Visits slots in list order, on a linear list without touching next[]
+#define DLLIST_FOR_EACH(dllist, slot)                          \
+    for(ssize_t slot = DLLIST_NEXT(dllist, 0);                 \
+        slot != 0;                                             \
+        slot = (dllist)->is_linear                             \
+            ? (slot < (dllist)->size ? slot + 1 : 0)           \
+            : DLLIST_NEXT(dllist, slot))
+
 dllist_err_t dllist_ctor(dllist_t* dllist, ssize_t init_cpcty, char* log_filename);
 
+dllist_err_t dllist_ctor_ex(dllist_t* dllist, const dllist_config_t* config);
+
+dllist_err_t dllist_from_array(dllist_t* dllist, const dllist_data_t* vals, ssize_t n, char* log_filename);
+
 void dllist_dtor(dllist_t* dllist);
 
 dllist_err_t dllist_insert_after(dllist_t* dllist, dllist_data_t val, ssize_t after);
 
+dllist_err_t dllist_insert_range_after(dllist_t* dllist, const dllist_data_t* vals, ssize_t n, ssize_t after);
+
 dllist_err_t dllist_delete_at(dllist_t* dllist, ssize_t at);
 
+dllist_err_t dllist_erase_range(dllist_t* dllist, ssize_t first, ssize_t last);
+
+dllist_err_t dllist_remove_if(dllist_t* dllist, dllist_pred_t pred, void* ctx);
+
+dllist_err_t dllist_remove_value(dllist_t* dllist, dllist_data_t val);
+
+dllist_err_t dllist_splice(dllist_t* dst, ssize_t after, dllist_t* src, ssize_t first, ssize_t last);
+
+dllist_err_t dllist_merge(dllist_t* dst, dllist_t* src);
+
 dllist_err_t dllist_linearize(dllist_t* dllist);
 
+dllist_err_t dllist_linearize_parallel(dllist_t* dllist, dllist_pool_t* pool);
+
+dllist_err_t dllist_sort(dllist_t* dllist, dllist_cmp_t cmp, void* ctx, int linearize);
+
+dllist_err_t dllist_parallel_for_each(dllist_t* dllist, dllist_pool_t* pool, dllist_walk_t walk, dllist_visit_t visit, void* ctx);
+
+dllist_err_t dllist_parallel_reduce(dllist_t* dllist, dllist_pool_t* pool, dllist_walk_t walk, int64_t init, dllist_fold_t fold, dllist_combine_t combine, void* ctx, int64_t* res);
+
+dllist_err_t dllist_reserve(dllist_t* dllist, ssize_t n);
+
+dllist_err_t dllist_shrink_to_fit(dllist_t* dllist);
+
+dllist_err_t dllist_compact(dllist_t* dllist, ssize_t budget);
+
+void dllist_auto_compact(dllist_t* dllist, ssize_t step);
+
+dllist_err_t dllist_near_enable(dllist_t* dllist);
+
+void dllist_near_disable(dllist_t* dllist);
+
+dllist_err_t dllist_save(dllist_t* dllist, const char* path);
+
+dllist_err_t dllist_load_mmap(dllist_t* dllist, const char* path, char* log_filename);
+
+dllist_err_t dllist_ctor_file(dllist_t* dllist, const char* path, ssize_t init_cpcty, char* log_filename);
+
+dllist_err_t dllist_sync(dllist_t* dllist, int wait);
+
+dllist_err_t dllist_take_slots(dllist_t* dllist, ssize_t* slots, ssize_t n);
+
+void dllist_release_slots(dllist_t* dllist, const ssize_t* slots, ssize_t n);
+
 ssize_t dllist_next(dllist_t* dllist, ssize_t after);
 
 ssize_t dllist_prev(dllist_t* dllist, ssize_t before);
@@ -71,3 +331,25 @@ ssize_t dllist_begin(dllist_t* dllist);
 
 ssize_t dllist_end(dllist_t* dllist);
 
+ssize_t dllist_at(dllist_t* dllist, ssize_t pos);
+
+ssize_t dllist_pos_of(dllist_t* dllist, ssize_t slot);
+
+dllist_err_t dllist_insert_at_pos(dllist_t* dllist, ssize_t pos, dllist_data_t val);
+
+ssize_t dllist_find(dllist_t* dllist, dllist_data_t val);
+
+ssize_t dllist_count(dllist_t* dllist, dllist_data_t val);
+
+ssize_t dllist_find_first(dllist_t* dllist, dllist_data_t val);
+
+dllist_err_t dllist_hash_enable(dllist_t* dllist);
+
+void dllist_hash_disable(dllist_t* dllist);
+
+ssize_t dllist_lookup(dllist_t* dllist, dllist_data_t val);
+
+dllist_err_t dllist_order_enable(dllist_t* dllist);
+
+void dllist_order_disable(dllist_t* dllist);
+
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "dllist.h"
+
+// Allocators for the node block of a list, passed to dllist_ctor_ex. The
+// indices and bitmaps stay on the heap; the node block is what random
+// access hits. An allocator must outlive every list constructed with it.
+
+typedef struct dllist_alloc_t
+{
+    void* (*alloc)(void* ctx, size_t size);
+
+    // contents kept up to the smaller size; NULL on failure, ptr intact
+    void* (*grow)(void* ctx, void* ptr, size_t old_size, size_t size);
+
+    void  (*free)(void* ctx, void* ptr, size_t size);
+
+    // optional: nonzero if ptr now holds size bytes where it is
+    int   (*resize_in_place)(void* ctx, void* ptr, size_t old_size, size_t size);
+
+    void* ctx;
+
+} dllist_alloc_t;
+
+// One block bumped through front to back. A grow of the last allocation
+// extends it, any other copies; only the last one is given back by free
+typedef struct dllist_arena_t
+{
+    char*  base;
+    size_t cpcty;
+    size_t used;
+    size_t last;   // offset of the last allocation
+
+} dllist_arena_t;
+
+dllist_err_t dllist_arena_ctor(dllist_arena_t* arena, size_t cpcty);
+
+void dllist_arena_dtor(dllist_arena_t* arena);
+
+void dllist_alloc_arena(dllist_alloc_t* alloc, dllist_arena_t* arena);
+
+// Anonymous mappings in 2 MiB steps advised MADV_HUGEPAGE, so that the
+// kernel backs them with transparent huge pages; grown by mremap
+void dllist_alloc_huge(dllist_alloc_t* alloc);
+
+// Anonymous mappings bound to one NUMA node with mbind before they are
+// touched; grown by mremap
+void dllist_alloc_numa(dllist_alloc_t* alloc, int node);
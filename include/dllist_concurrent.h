@@ -0,0 +1,63 @@
+#pragma once
+
+#include <pthread.h>
+
+#include "dllist.h"
+
+// Concurrent list: inserts and deletes from several threads run in
+// parallel under striped node locks. Every mutation holds grow_lock
+// shared; only slot allocation, which may move the arrays, takes it
+// exclusively. Slots come from a per-thread cache in
+// dllist_concurrent_ctx_t, so the shared free list is touched once per
+// DLLIST_CONCURRENT_CACHE / 2 operations.
+//
+// A thread must not delete a node another thread is inserting after or
+// deleting. Traversal and the hash/order indices of the underlying list
+// are not supported while mutations are running.
+
+#ifndef DLLIST_CONCURRENT_STRIPES
+#define DLLIST_CONCURRENT_STRIPES 64
+#endif // DLLIST_CONCURRENT_STRIPES
+
+#ifndef DLLIST_CONCURRENT_CACHE
+#define DLLIST_CONCURRENT_CACHE 64
+#endif // DLLIST_CONCURRENT_CACHE
+
+// one lock per cache line
+typedef struct __attribute__((aligned(64))) dllist_concurrent_stripe_t
+{
+    pthread_mutex_t mutex;
+
+} dllist_concurrent_stripe_t;
+
+typedef struct dllist_concurrent_t
+{
+    dllist_t list;
+
+    pthread_rwlock_t grow_lock;
+
+    dllist_concurrent_stripe_t stripe[DLLIST_CONCURRENT_STRIPES];
+
+} dllist_concurrent_t;
+
+// Owned by one thread; flush it before the thread is done with the list
+typedef struct dllist_concurrent_ctx_t
+{
+    ssize_t slots[DLLIST_CONCURRENT_CACHE];
+    ssize_t cnt;
+
+} dllist_concurrent_ctx_t;
+
+dllist_err_t dllist_concurrent_ctor(dllist_concurrent_t* clist, ssize_t init_cpcty, char* log_filename);
+
+void dllist_concurrent_dtor(dllist_concurrent_t* clist);
+
+void dllist_concurrent_ctx_init(dllist_concurrent_ctx_t* ctx);
+
+void dllist_concurrent_ctx_flush(dllist_concurrent_t* clist, dllist_concurrent_ctx_t* ctx);
+
+dllist_err_t dllist_concurrent_insert_after(dllist_concurrent_t* clist, dllist_concurrent_ctx_t* ctx, dllist_data_t val, ssize_t after, ssize_t* slot);
+
+dllist_err_t dllist_concurrent_delete_at(dllist_concurrent_t* clist, dllist_concurrent_ctx_t* ctx, ssize_t at);
+
+ssize_t dllist_concurrent_size(dllist_concurrent_t* clist);
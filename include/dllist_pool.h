@@ -0,0 +1,60 @@
+#pragma once
+
+#include <pthread.h>
+
+#include "dllist.h"
+
+// Fork-join thread pool for the bulk operations. dllist_pool_run calls
+// the job once on every worker, the calling thread being worker 0, and
+// returns when all of them are done; workers split the work by their id.
+//
+// dllist_pool_for balances uneven work: [0, n) is dealt out evenly, each
+// worker eats its range grain items at a time from the front, and a
+// worker that runs dry steals the back half of another one's range.
+
+typedef void (*dllist_pool_job_t)(void* ctx, int worker, int nworkers);
+
+typedef void (*dllist_pool_range_t)(void* ctx, int worker, ssize_t lo, ssize_t hi);
+
+// what is left of a worker's share, one per cache line
+typedef struct __attribute__((aligned(64))) dllist_pool_deque_t
+{
+    pthread_mutex_t mutex;
+
+    ssize_t lo;
+    ssize_t hi;
+
+} dllist_pool_deque_t;
+
+typedef struct dllist_pool_t
+{
+    pthread_t* thread;
+    int nthreads;   // workers including the caller
+
+    dllist_pool_deque_t* deque;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t  start;
+    pthread_cond_t  done;
+
+    dllist_pool_job_t job;
+    void* ctx;
+
+    long gen;       // bumped by every run, workers wait for it to change
+    int pending;
+    int stop;
+
+} dllist_pool_t;
+
+// nthreads = 0 takes one worker per online CPU
+dllist_err_t dllist_pool_ctor(dllist_pool_t* pool, int nthreads);
+
+void dllist_pool_dtor(dllist_pool_t* pool);
+
+void dllist_pool_run(dllist_pool_t* pool, dllist_pool_job_t job, void* ctx);
+
+void dllist_pool_for(dllist_pool_t* pool, ssize_t n, ssize_t grain, dllist_pool_range_t body, void* ctx);
+
+// [lo, hi) share of n items for a worker, contiguous and balanced
+#define DLLIST_POOL_LO(n, worker, nworkers) ((n) * (worker) / (nworkers))
+#define DLLIST_POOL_HI(n, worker, nworkers) ((n) * ((worker) + 1) / (nworkers))
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "dllist.h"
+
+// Single writer, lock-free readers. The writer links nodes in with
+// release stores and never touches a deleted node until every reader
+// that could still stand on it has left: deleted slots are retired with
+// the current epoch and go back on the free list only once no reader
+// entered at that epoch or earlier is still reading. Growth copies the
+// nodes into a new buffer, publishes it and retires the old one the
+// same way, so readers never see memory freed under them.
+//
+// Readers register once, then bracket every traversal with
+// dllist_rcu_read_lock / dllist_rcu_read_unlock and walk the buffer the
+// lock returned.
+
+#ifndef DLLIST_RCU_READERS
+#define DLLIST_RCU_READERS 64
+#endif // DLLIST_RCU_READERS
+
+#ifndef DLLIST_RCU_RECLAIM_BATCH
+#define DLLIST_RCU_RECLAIM_BATCH 64
+#endif // DLLIST_RCU_RECLAIM_BATCH
+
+typedef struct dllist_rcu_buf_t
+{
+    dllist_data_t* data;
+
+    dllist_idx_t* next;
+    dllist_idx_t* prev;   // read by the writer only
+
+    ssize_t cpcty;
+
+} dllist_rcu_buf_t;
+
+// epoch a reader entered at, 0 while it is outside a read section
+typedef struct __attribute__((aligned(64))) dllist_rcu_reader_t
+{
+    ssize_t epoch;
+    int used;
+
+} dllist_rcu_reader_t;
+
+typedef struct dllist_rcu_retired_t
+{
+    ssize_t slot;
+    ssize_t epoch;
+
+} dllist_rcu_retired_t;
+
+typedef struct dllist_rcu_t
+{
+    dllist_rcu_buf_t* buf;
+
+    ssize_t epoch;
+
+    // writer only
+    ssize_t free;
+    ssize_t hwm;
+    ssize_t size;
+
+    dllist_rcu_retired_t* retired;
+    ssize_t retired_cnt;
+    ssize_t retired_cpcty;
+
+    dllist_rcu_buf_t* old_buf[64];   // retired buffers, one per growth
+    ssize_t old_epoch[64];
+    ssize_t old_cnt;
+
+    dllist_rcu_reader_t reader[DLLIST_RCU_READERS];
+
+} dllist_rcu_t;
+
+// Valid inside a read section on the buffer it returned
+#define DLLIST_RCU_DATA(buf, ind) ((buf)->data[ind])
+#define DLLIST_RCU_NEXT(buf, ind) (__atomic_load_n(&(buf)->next[ind], __ATOMIC_ACQUIRE))
+
+dllist_err_t dllist_rcu_ctor(dllist_rcu_t* rcu, ssize_t init_cpcty);
+
+void dllist_rcu_dtor(dllist_rcu_t* rcu);
+
+dllist_err_t dllist_rcu_insert_after(dllist_rcu_t* rcu, dllist_data_t val, ssize_t after, ssize_t* slot);
+
+dllist_err_t dllist_rcu_delete_at(dllist_rcu_t* rcu, ssize_t at);
+
+void dllist_rcu_reclaim(dllist_rcu_t* rcu);
+
+ssize_t dllist_rcu_reader_register(dllist_rcu_t* rcu);
+
+void dllist_rcu_reader_unregister(dllist_rcu_t* rcu, ssize_t reader);
+
+const dllist_rcu_buf_t* dllist_rcu_read_lock(dllist_rcu_t* rcu, ssize_t reader);
+
+void dllist_rcu_read_unlock(dllist_rcu_t* rcu, ssize_t reader);
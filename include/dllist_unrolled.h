@@ -0,0 +1,65 @@
+#pragma once
+
+#include "dllist.h"
+
+// Unrolled list: every node of the underlying dllist is a block of up
+// to DLLIST_UNROLLED_BLOCK values and its data field holds the fill
+// count, so a traversal scans values sequentially and follows one link
+// per block. Blocks are split when full and merged with a neighbour when
+// the two together drop to half a block.
+
+#ifndef DLLIST_UNROLLED_BLOCK
+#define DLLIST_UNROLLED_BLOCK 32
+#endif // DLLIST_UNROLLED_BLOCK
+
+#define DLLIST_UNROLLED_FILL(ulist, blk) DLLIST_DATA(&(ulist)->blocks, blk)
+#define DLLIST_UNROLLED_VALS(ulist, blk) ((ulist)->vals + (blk) * DLLIST_UNROLLED_BLOCK)
+
+#define DLLIST_UNROLLED_AT(ulist, it) (DLLIST_UNROLLED_VALS(ulist, (it).block)[(it).off])
+
+#define DLLIST_UNROLLED_MAKE(varname) \
+    dllist_unrolled_t varname = {     \
+        .blocks = DLLIST_INIT,        \
+        .vals   = NULL,               \
+        .vcpcty = 0,                  \
+        .size   = 0                   \
+    }
+
+typedef struct dllist_unrolled_t
+{
+    dllist_t blocks;
+
+    dllist_data_t* vals;   // DLLIST_UNROLLED_BLOCK values per block slot
+    ssize_t vcpcty;        // block slots covered by vals
+
+    ssize_t size;          // values, not blocks
+
+} dllist_unrolled_t;
+
+// An element is addressed by its block slot and offset in the block;
+// block DLLIST_NULL_ stands for before the first / past the last one
+typedef struct dllist_unrolled_it_t
+{
+    ssize_t block;
+    ssize_t off;
+
+} dllist_unrolled_it_t;
+
+// Visits blocks in list order, scan DLLIST_UNROLLED_VALS up to the fill
+#define DLLIST_UNROLLED_FOR_EACH_BLOCK(ulist, blk) DLLIST_FOR_EACH(&(ulist)->blocks, blk)
+
+dllist_err_t dllist_unrolled_ctor(dllist_unrolled_t* ulist, ssize_t init_cpcty, char* log_filename);
+
+void dllist_unrolled_dtor(dllist_unrolled_t* ulist);
+
+dllist_err_t dllist_unrolled_push_back(dllist_unrolled_t* ulist, dllist_data_t val);
+
+dllist_err_t dllist_unrolled_insert_after(dllist_unrolled_t* ulist, dllist_unrolled_it_t* it, dllist_data_t val);
+
+dllist_err_t dllist_unrolled_delete_at(dllist_unrolled_t* ulist, dllist_unrolled_it_t* it);
+
+dllist_unrolled_it_t dllist_unrolled_begin(dllist_unrolled_t* ulist);
+
+dllist_unrolled_it_t dllist_unrolled_next(dllist_unrolled_t* ulist, dllist_unrolled_it_t it);
+
+dllist_unrolled_it_t dllist_unrolled_at(dllist_unrolled_t* ulist, ssize_t pos);
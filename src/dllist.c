@@ -2,9 +2,23 @@
 
 #include <assert.h>
 #include <ctime>
+#include <limits.h>
 #include <memory.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "dllist_alloc.h"
+#include "dllist_pool.h"
 
 #include "memutils.h"
 #include "ioutils.h"
@@ -49,319 +63,3611 @@
 
 #endif // _DEBUG
 
-static const ssize_t DLLIST_NULL_ = 0;
+static const ssize_t DLLIST_NULL_ = 0;
+
+static const ssize_t DLLIST_NONE_ = -1;
+
+static const ssize_t DLLIST_CPCTY_THREASHOLD_ = 5;
+
+#ifdef DLLIST_IDX32
+
+static const ssize_t DLLIST_IDX_MAX_ = INT32_MAX;
+
+#define DLLIST_IDX_(val) ((dllist_idx_t)(val))
+#define DLLIST_IDX_FMT_ "%d"
+
+#else // DLLIST_IDX32
+
+static const ssize_t DLLIST_IDX_MAX_ = SSIZE_MAX;
+
+#define DLLIST_IDX_(val) (val)
+#define DLLIST_IDX_FMT_ "%ld"
+
+#endif // DLLIST_IDX32
+
+#ifdef DLLIST_AOS
+static const size_t DLLIST_NODE_SIZE_ = sizeof(dllist_node_t);
+#else // DLLIST_AOS
+static const size_t DLLIST_NODE_SIZE_ = sizeof(dllist_idx_t) * 2 + sizeof(dllist_data_t);
+#endif // DLLIST_AOS
+
+// Value scans compare a vector of data[] at once; only the SoA layout 
+// keeps values contiguous, AoS scans are scalar
+#if !defined(DLLIST_AOS) && defined(__AVX2__)
+
+#define DLLIST_SIMD_WIDTH_ 8
+
+typedef __m256i dllist_simd_t_;
+
+#define DLLIST_SIMD_SET_(val) _mm256_set1_epi32(val)
+
+#define DLLIST_SIMD_MATCH_(ptr, key)                                                \
+    (unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(           \
+        _mm256_loadu_si256((const __m256i*)(ptr)), key)))
+
+#elif !defined(DLLIST_AOS) && defined(__SSE2__)
+
+#define DLLIST_SIMD_WIDTH_ 4
+
+typedef __m128i dllist_simd_t_;
+
+#define DLLIST_SIMD_SET_(val) _mm_set1_epi32(val)
+
+#define DLLIST_SIMD_MATCH_(ptr, key)                                                \
+    (unsigned) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(                    \
+        _mm_loadu_si128((const __m128i*)(ptr)), key)))
+
+#endif
+
+#ifdef DLLIST_SIMD_WIDTH_
+static_assert(sizeof(dllist_data_t) == sizeof(int32_t), "SIMD scan compares 32-bit lanes");
+#endif // DLLIST_SIMD_WIDTH_
+
+// Each distinct value owns one bucket of an open-addressing table 
+// (linear probing, load kept under a half) holding one of its slots;
+// other slots with the same value are chained through hnext/hprev
+struct dllist_hash_t
+{
+    dllist_data_t* keys;
+    dllist_idx_t*  heads; // DLLIST_NULL_ marks an empty bucket
+
+    int     bits;         // the table has 1 << bits buckets
+    ssize_t used;         // distinct values
+
+    dllist_idx_t* hnext;
+    dllist_idx_t* hprev;
+
+    ssize_t cpcty;        // slots covered by hnext and hprev
+};
+
+static const int DLLIST_HASH_MIN_BITS_ = 4;
+
+// A treap over the live slots: its in-order walk is the list, subtree 
+// sizes give positions, and the heap priority of a node is a hash of 
+// its slot, so priorities take no storage
+typedef struct dllist_order_node_t
+{
+    dllist_idx_t left;
+    dllist_idx_t right;
+    dllist_idx_t parent;
+    dllist_idx_t cnt;     // nodes in the subtree, 0 for DLLIST_NULL_
+
+} dllist_order_node_t;
+
+struct dllist_order_t
+{
+    // a tree node per slot, kept apart from the list storage so that a 
+    // descent touches one line per level
+    dllist_order_node_t* node;
+
+    ssize_t root;
+    ssize_t cpcty;        // slots covered by node
+};
+
+// free list entries a compaction step takes off per node it may move
+static const ssize_t DLLIST_COMPACT_DETACH_ = 64;
+
+// bitmap words searched either side of the insertion point for a free 
+// slot; with 8-byte links 512 slots of next[] are one 4 KiB page
+static const ssize_t DLLIST_NEAR_WORDS_ = 8;
+
+// slots a list with max_cpcty set grows by at a time unless told 
+// otherwise; committing them costs the same however long the list is
+static const ssize_t DLLIST_SEGMENT_ = 1 << 16;
+
+// Snapshot header, followed by the node block laid out by dllist_carve_ 
+// for cpcty slots; 64 bytes keep the arrays of a mapping aligned. The 
+// byte order, layout and widths must match the build that loads it
+typedef struct dllist_file_hdr_t_
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t endian;      // DLLIST_FILE_ENDIAN_ as the writer stored it
+
+    uint16_t aos;
+    uint16_t idx_size;
+    uint16_t data_size;
+    uint16_t is_linear;
+
+    int64_t cpcty;        // slots in the file, the writer's hwm
+    int64_t hwm;
+    int64_t size;
+    int64_t free;
+
+    uint8_t reserved[8];
+
+} dllist_file_hdr_t_;
+
+static_assert(sizeof(dllist_file_hdr_t_) == 64, "snapshot header must stay 64 bytes");
+
+static const char DLLIST_FILE_MAGIC_[8] = "dllist";
+
+static const uint32_t DLLIST_FILE_VERSION_ = 1;
+
+static const uint32_t DLLIST_FILE_ENDIAN_ = 0x01020304;
+
+// Below this many elements dllist_linearize_parallel runs the serial one
+static const ssize_t DLLIST_PARALLEL_MIN_ = 1 << 16;
+
+// sublists per worker, enough to even out their random lengths
+static const ssize_t DLLIST_RANK_SUBS_PER_WORKER_ = 64;
+
+#define DLLIST_RANK_MARKED_(mark, slot) ((mark)[(slot) / 64] & (1ull << ((slot) % 64)))
+
+// A run of the list from one splitter up to the next one
+typedef struct dllist_rank_sub_t_
+{
+    ssize_t head;
+    ssize_t len;
+    ssize_t succ;   // sublist that follows, -1 for the last one
+    ssize_t off;    // position of head in the list
+
+} dllist_rank_sub_t_;
+
+typedef struct dllist_rank_ctx_t_
+{
+    dllist_t* dllist;
+
+    uint64_t* mark;           // bit per slot, set on splitter heads
+
+    dllist_rank_sub_t_* sub;
+    ssize_t nsub;
+    ssize_t taken;            // sublists handed out to walkers
+
+    dllist_data_t* scratch;   // data by position
+
+} dllist_rank_ctx_t_;
+
+// slots per unit of work when walking in slot order
+static const ssize_t DLLIST_PARALLEL_CHUNK_ = 4096;
+
+// One parallel walk; a unit of work is a chunk of slots, or a sublist 
+// when a non-linear list is walked in list order
+typedef struct dllist_walk_ctx_t_
+{
+    dllist_t* dllist;
+
+    dllist_visit_t visit;     // for_each, NULL for reduce
+    dllist_fold_t  fold;
+    int64_t        init;
+    void*          ctx;
+
+    int64_t* partial;         // one per unit
+
+    uint64_t* mark;
+    dllist_rank_sub_t_* sub;  // NULL when walking chunks
+    ssize_t nsub;
+
+} dllist_walk_ctx_t_;
+
+static dllist_err_t dllist_realloc_arr_(void** ptr, ssize_t nmemb, size_t tsize);
+
+static dllist_err_t dllist_realloc_idx_(dllist_idx_t** arr, ssize_t nmemb);
+
+static dllist_err_t dllist_block_resize_(dllist_t* dllist, void** block, ssize_t cpcty, ssize_t nw_cpcty);
+
+static void* dllist_block_(dllist_t* dllist);
+
+static void dllist_carve_(dllist_t* dllist, void* block, ssize_t cpcty);
+
+static dllist_err_t dllist_vm_reserve_(dllist_t* dllist, ssize_t max_cpcty);
+
+static dllist_err_t dllist_vm_commit_(dllist_t* dllist, ssize_t nw_cpcty);
+
+static dllist_err_t dllist_realloc_(dllist_t* dllist, ssize_t nw_cpcty);
+
+static ssize_t dllist_grow_cpcty_(const dllist_t* dllist, ssize_t min_cpcty);
+
+static dllist_err_t dllist_grow_(dllist_t* dllist, ssize_t min_cpcty);
+
+static dllist_err_t dllist_take_slot_(dllist_t* dllist, ssize_t* slot);
+
+static dllist_err_t dllist_take_slot_near_(dllist_t* dllist, ssize_t after, ssize_t* slot);
+
+static void dllist_unlink_(dllist_t* dllist, ssize_t at);
+
+static dllist_err_t dllist_reserve_run_(dllist_t* dllist, ssize_t n);
+
+static void dllist_link_run_(dllist_t* dllist, ssize_t n, ssize_t after);
+
+static void dllist_clear_(dllist_t* dllist);
+
+static void dllist_init_(dllist_t* dllist);
+
+static void dllist_free_slot_(dllist_t* dllist, ssize_t slot);
+
+static dllist_err_t dllist_compact_(dllist_t* dllist, ssize_t budget);
+
+static ssize_t dllist_compact_hole_(dllist_t* dllist);
+
+static void dllist_compact_move_(dllist_t* dllist, ssize_t from, ssize_t to);
+
+static void dllist_compact_end_(dllist_t* dllist);
+
+static void dllist_compact_abort_(dllist_t* dllist);
+
+static void dllist_compact_auto_(dllist_t* dllist);
+
+static void dllist_freemap_clear_(dllist_t* dllist);
+
+static dllist_err_t dllist_unmap_(dllist_t* dllist, ssize_t nw_cpcty);
+
+static dllist_err_t dllist_file_check_(const dllist_file_hdr_t_* hdr, off_t file_size);
+
+static ssize_t dllist_bitmap_chain_(dllist_t* dllist, const uint64_t* map, ssize_t head);
+
+static void dllist_bitmap_unchain_(dllist_t* dllist, ssize_t head);
+
+static void dllist_file_hdr_(dllist_t* dllist, dllist_file_hdr_t_* hdr, ssize_t cpcty, ssize_t free_head);
+
+static dllist_err_t dllist_file_resize_(dllist_t* dllist, void** block, ssize_t nw_cpcty);
+
+static void dllist_map_advise_(dllist_t* dllist);
+
+static dllist_err_t dllist_bitmap_fit_(uint64_t** map, ssize_t cpcty, ssize_t nw_cpcty);
+
+static ssize_t dllist_bitmap_lowest_(const uint64_t* map, ssize_t* lo, ssize_t hwm);
+
+static ssize_t dllist_bitmap_near_(const uint64_t* map, ssize_t after, ssize_t hwm);
+
+static ssize_t dllist_rank_split_(dllist_t* dllist, uint64_t* mark, dllist_rank_sub_t_* sub, ssize_t nsub);
+
+static int dllist_rank_cmp_(const void* lhs, const void* rhs);
+
+static ssize_t dllist_rank_find_(const dllist_rank_sub_t_* sub, ssize_t nsub, ssize_t head);
+
+static ssize_t dllist_sort_merge_(dllist_t* dllist, ssize_t lhs, ssize_t rhs, dllist_cmp_t cmp, void* ctx);
+
+static void dllist_sort_relink_(dllist_t* dllist);
+
+static dllist_err_t dllist_radix_sort_(dllist_t* dllist, int linearize);
+
+static int dllist_radix_pass_(const uint32_t* key, const dllist_idx_t* slot, uint32_t* key_out, dllist_idx_t* slot_out, ssize_t n, int shift);
+
+static void dllist_rank_walk_job_(void* arg, int worker, int nworkers);
+
+static void dllist_rank_scatter_job_(void* arg, int worker, int nworkers);
+
+static void dllist_rank_relink_job_(void* arg, int worker, int nworkers);
+
+static dllist_err_t dllist_walk_(dllist_t* dllist, dllist_pool_t* pool, dllist_walk_t walk, dllist_walk_ctx_t_* wctx, dllist_combine_t combine, int64_t* res);
+
+static inline int64_t dllist_walk_one_(dllist_walk_ctx_t_* wctx, ssize_t ind, int64_t acc);
+
+static void dllist_walk_body_(void* arg, int worker, ssize_t lo, ssize_t hi);
+
+static size_t dllist_hash_home_(const dllist_hash_t* hash, dllist_data_t val);
+
+static size_t dllist_hash_probe_(const dllist_hash_t* hash, dllist_data_t val);
+
+static dllist_err_t dllist_hash_rehash_(dllist_hash_t* hash, int bits);
+
+static dllist_err_t dllist_hash_reserve_(dllist_t* dllist, ssize_t n);
+
+static dllist_err_t dllist_hash_fit_(dllist_t* dllist, ssize_t cpcty);
+
+static void dllist_hash_add_(dllist_t* dllist, ssize_t slot);
+
+static void dllist_hash_remove_(dllist_t* dllist, ssize_t slot);
+
+static void dllist_hash_rebuild_(dllist_t* dllist);
+
+static uint64_t dllist_order_prio_(ssize_t slot);
+
+static void dllist_order_rotate_up_(dllist_order_t* order, ssize_t x);
+
+static dllist_err_t dllist_order_fit_(dllist_t* dllist, ssize_t cpcty);
+
+static void dllist_order_insert_(dllist_t* dllist, ssize_t slot, ssize_t after);
+
+static void dllist_order_remove_(dllist_t* dllist, ssize_t slot);
+
+static void dllist_order_rebuild_(dllist_t* dllist);
+
+static ssize_t dllist_order_at_(const dllist_order_t* order, ssize_t pos);
+
+static ssize_t dllist_order_pos_(const dllist_order_t* order, ssize_t slot);
+
+static dllist_err_t dllist_index_fit_(dllist_t* dllist, ssize_t cpcty);
+
+static void dllist_index_link_(dllist_t* dllist, ssize_t slot, ssize_t after);
+
+static void dllist_index_unlink_(dllist_t* dllist, ssize_t slot);
+
+static void dllist_index_rebuild_(dllist_t* dllist);
+
+
+#ifdef _DEBUG
+
+static dllist_err_t dllist_verify_(dllist_t* dllist);
+
+static dllist_err_t dllist_verify_hash_(dllist_t* dllist);
+
+static dllist_err_t dllist_verify_order_(dllist_t* dllist);
+
+char* dllist_dump_graphviz_(dllist_t* dllist);
+
+void dllist_dump_(dllist_t* dllist, dllist_err_t err, char* msg, const char* filename, int line, const char* funcname);
+
+static const char* dllist_strerr_(dllist_err_t err);
+
+#endif // _DEBUG
+
+
+dllist_err_t dllist_ctor(dllist_t* dllist, ssize_t init_cpcty, char* log_filename)
+{
+    dllist_config_t config = {};
+
+    config.init_cpcty   = init_cpcty;
+    config.log_filename = log_filename;
+
+    return dllist_ctor_ex(dllist, &config);
+}
+
+dllist_err_t dllist_ctor_ex(dllist_t* dllist, const dllist_config_t* config)
+{
+    utils_assert(dllist);
+    utils_assert(config);
+    utils_assert(config->init_cpcty >= 0);
+    utils_assert(config->max_cpcty >= 0);
+    utils_assert(config->growth.step >= 0);
+    utils_assert(config->growth.factor <= 0 || config->growth.factor > 1);
+
+    IF_DEBUG(
+        utils_assert(config->log_filename);
+        utils_init_log_file(config->log_filename, LOG_DIR);
+    )
+
+    dllist_err_t err = DLLIST_NONE;
+
+    dllist_init_(dllist);
+
+    dllist->alloc  = config->alloc;
+    dllist->growth = config->growth;
+
+    ssize_t init_cpcty_vld = 
+        config->init_cpcty < DLLIST_CPCTY_THREASHOLD_ 
+        ? DLLIST_CPCTY_THREASHOLD_ 
+        : config->init_cpcty;
+
+    if(config->max_cpcty) {
+        err = dllist_vm_reserve_(dllist, config->max_cpcty < init_cpcty_vld ? init_cpcty_vld : config->max_cpcty);
+        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    }
+
+    err = dllist_realloc_(dllist, init_cpcty_vld);
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    
+    dllist_clear_(dllist);
+
+    DLLIST_DUMP_(dllist,err);
+
+    return DLLIST_NONE;
+}
+
+// Everything a constructor does not take from its arguments, so that a 
+// list zeroed or left as it was by dllist_dtor is as good as DLLIST_INIT: 
+// fd 0 would otherwise be taken for a file backing the list
+static void dllist_init_(dllist_t* dllist)
+{
+    dllist->max_cpcty = 0;
+
+    dllist_carve_(dllist, NULL, 0);
+
+    dllist->free  = 0;
+    dllist->hwm   = 0;
+    dllist->cpcty = 0;
+    dllist->size  = 0;
+
+    dllist->is_linear = 0;
+
+    dllist->hash  = NULL;
+    dllist->order = NULL;
+
+    dllist->compact      = NULL;
+    dllist->compact_lo   = 0;
+    dllist->compact_step = 0;
+
+    dllist->freemap    = NULL;
+    dllist->freemap_lo = 0;
+
+    dllist->mapped = 0;
+    dllist->fd     = -1;
+
+    dllist->alloc  = NULL;
+    dllist->growth = {};
+}
+
+static void dllist_clear_(dllist_t* dllist)
+{
+    dllist_compact_end_(dllist);
+    dllist_freemap_clear_(dllist);
+
+    dllist->free = DLLIST_NULL_;
+    dllist->hwm  = DLLIST_NULL_ + 1;
+
+    DLLIST_DATA(dllist, DLLIST_NULL_) = 0;
+    DLLIST_NEXT(dllist, DLLIST_NULL_) = DLLIST_NULL_;
+    DLLIST_PREV(dllist, DLLIST_NULL_) = DLLIST_NULL_;
+    dllist->size                      = 0; 
+    dllist->is_linear                 = 1;
+
+    dllist_index_rebuild_(dllist);
+}
+
+void dllist_dtor(dllist_t* dllist)
+{
+    utils_assert(dllist);
+
+    void* block = dllist_block_(dllist);
+
+    // a file-backed list leaves its file loadable, the free slots of 
+    // the bitmaps chained into its free list
+    if(dllist->fd >= 0) {
+        ssize_t free_head = dllist->free;
+
+        free_head = dllist_bitmap_chain_(dllist, dllist->compact, free_head);
+        free_head = dllist_bitmap_chain_(dllist, dllist->freemap, free_head);
+
+        dllist_file_hdr_(dllist, (dllist_file_hdr_t_*) ((char*) block - sizeof(dllist_file_hdr_t_)), dllist->cpcty, free_head);
+    }
+
+    dllist_hash_disable(dllist);
+    dllist_order_disable(dllist);
+    dllist_compact_end_(dllist);
+
+    NFREE(dllist->freemap);
+
+    if(dllist->mapped) {
+        munmap((char*) block - sizeof(dllist_file_hdr_t_), dllist->mapped);
+        dllist->mapped = 0;
+    }
+    else if(dllist->max_cpcty) {
+        munmap(block, (size_t) dllist->max_cpcty * DLLIST_NODE_SIZE_);
+        dllist->max_cpcty = 0;
+    }
+    else if(block && dllist->alloc)
+        dllist->alloc->free(dllist->alloc->ctx, block, (size_t) dllist->cpcty * DLLIST_NODE_SIZE_);
+
+    else
+        NFREE(block);
+
+    if(dllist->fd >= 0) {
+        close(dllist->fd);
+        dllist->fd = -1;
+    }
+
+    dllist_carve_(dllist, NULL, 0);
+    
+    dllist->size  = 0;
+    dllist->free  = 0;
+    dllist->hwm   = 0;
+    dllist->cpcty = 0;
+
+    dllist->is_linear = 0;
+
+    IF_DEBUG(
+        utils_end_log();
+    )
+}
+
+static dllist_err_t dllist_realloc_arr_(void** ptr, ssize_t nmemb, size_t tsize)
+{
+    utils_assert(ptr);
+    utils_assert(nmemb > 0);
+
+    void* tmp = 
+        (dllist_data_t*)realloc(*ptr, (size_t) nmemb * tsize);
+
+    if(!tmp) return DLLIST_ALLOC_FAIL;
+
+    *ptr = tmp; 
+
+    return DLLIST_NONE;
+}
+
+// The node block goes through the list's allocator if it has one
+static dllist_err_t dllist_block_resize_(dllist_t* dllist, void** block, ssize_t cpcty, ssize_t nw_cpcty)
+{
+    const dllist_alloc_t* alloc = dllist->alloc;
+
+    if(!alloc)
+        return dllist_realloc_arr_(block, nw_cpcty, DLLIST_NODE_SIZE_);
+
+    size_t size    = (size_t) cpcty    * DLLIST_NODE_SIZE_;
+    size_t nw_size = (size_t) nw_cpcty * DLLIST_NODE_SIZE_;
+
+    if(*block && alloc->resize_in_place && alloc->resize_in_place(alloc->ctx, *block, size, nw_size))
+        return DLLIST_NONE;
+
+    void* tmp = 
+        *block 
+        ? alloc->grow(alloc->ctx, *block, size, nw_size) 
+        : alloc->alloc(alloc->ctx, nw_size);
+
+    if(!tmp) return DLLIST_ALLOC_FAIL;
+
+    *block = tmp;
+
+    return DLLIST_NONE;
+}
+
+static dllist_err_t dllist_realloc_idx_(dllist_idx_t** arr, ssize_t nmemb)
+{
+    utils_assert(arr);
+
+    void* tmp = *arr;
+
+    dllist_err_t err = dllist_realloc_arr_(&tmp, nmemb, sizeof(dllist_idx_t));
+    if(err != DLLIST_NONE)
+        return err;
+
+    *arr = (dllist_idx_t*) tmp;
+
+    return DLLIST_NONE;
+}
+
+static void* dllist_block_(dllist_t* dllist)
+{
+#ifdef DLLIST_AOS
+    return dllist->node;
+#else // DLLIST_AOS
+    return dllist->next;
+#endif // DLLIST_AOS
+}
+
+static void dllist_carve_(dllist_t* dllist, void* block, ssize_t cpcty)
+{
+#ifdef DLLIST_AOS
+    (void) cpcty;
+
+    dllist->node = (dllist_node_t*) block;
+#else // DLLIST_AOS
+    char* base = (char*) block;
+
+    if(!base) {
+        dllist->next = NULL;
+        dllist->prev = NULL;
+        dllist->data = NULL;
+        return;
+    }
+
+    // a reserved block is laid out once for all it may grow to
+    if(dllist->max_cpcty)
+        cpcty = dllist->max_cpcty;
+
+    // widest type first to keep every array aligned
+    dllist->next = (dllist_idx_t*)  base;
+    dllist->prev = (dllist_idx_t*)  (base + (size_t) cpcty * sizeof(dllist_idx_t));
+    dllist->data = (dllist_data_t*) (base + (size_t) cpcty * sizeof(dllist_idx_t) * 2);
+#endif // DLLIST_AOS
+}
+
+// Shrinking keeps the slots below the high-water mark. A failed shrink 
+// leaves the block as it was, only larger than needed
+static dllist_err_t dllist_realloc_(dllist_t* dllist, ssize_t nw_cpcty)
+{
+    utils_assert(dllist);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    if(nw_cpcty > DLLIST_IDX_MAX_ || (dllist->max_cpcty && nw_cpcty > dllist->max_cpcty))
+        err = DLLIST_CPCTY_OVERFLOW;
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    utils_assert(nw_cpcty >= dllist->hwm && nw_cpcty != dllist->cpcty);
+
+    err = dllist_index_fit_(dllist, nw_cpcty);
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    err = dllist_bitmap_fit_(&dllist->compact, dllist->cpcty, nw_cpcty);
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    err = dllist_bitmap_fit_(&dllist->freemap, dllist->cpcty, nw_cpcty);
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    // a snapshot mapped copy-on-write moves to the heap
+    if(dllist->mapped && dllist->fd < 0)
+        return dllist_unmap_(dllist, nw_cpcty);
+
+    // a reserved block is resized where it is
+    if(dllist->max_cpcty)
+        return dllist_vm_commit_(dllist, nw_cpcty);
+
+    void* block = dllist_block_(dllist);
+
+#ifndef DLLIST_AOS
+    // next stays at the base, prev and data are shifted to their new 
+    // offsets: on growth after the realloc, upper one first, on shrink 
+    // before it, lower one first, as the regions may overlap; slots past 
+    // the high-water mark hold nothing and are not moved
+    char* base = (char*) block;
+
+    if(base && nw_cpcty < dllist->cpcty) {
+        memmove(
+            base + (size_t) nw_cpcty      * sizeof(dllist_idx_t),
+            base + (size_t) dllist->cpcty * sizeof(dllist_idx_t),
+            (size_t) dllist->hwm * sizeof(dllist_idx_t)
+        );
+
+        memmove(
+            base + (size_t) nw_cpcty      * sizeof(dllist_idx_t) * 2,
+            base + (size_t) dllist->cpcty * sizeof(dllist_idx_t) * 2,
+            (size_t) dllist->hwm * sizeof(dllist_data_t)
+        );
+    }
+#endif // DLLIST_AOS
+
+    if(dllist->fd >= 0)
+        err = dllist_file_resize_(dllist, &block, nw_cpcty);
+    else
+        err = dllist_block_resize_(dllist, &block, dllist->cpcty, nw_cpcty);
+
+    if(nw_cpcty < dllist->cpcty)
+        err = DLLIST_NONE;
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+#ifndef DLLIST_AOS
+    base = (char*) block;
+
+    if(nw_cpcty > dllist->cpcty) {
+        memmove(
+            base + (size_t) nw_cpcty      * sizeof(dllist_idx_t) * 2,
+            base + (size_t) dllist->cpcty * sizeof(dllist_idx_t) * 2,
+            (size_t) dllist->hwm * sizeof(dllist_data_t)
+        );
+
+        memmove(
+            base + (size_t) nw_cpcty      * sizeof(dllist_idx_t),
+            base + (size_t) dllist->cpcty * sizeof(dllist_idx_t),
+            (size_t) dllist->hwm * sizeof(dllist_idx_t)
+        );
+    }
+#endif // DLLIST_AOS
+
+    dllist_carve_(dllist, block, nw_cpcty);
+
+    dllist->cpcty = nw_cpcty;
+
+    if(dllist->fd >= 0)
+        dllist_map_advise_(dllist);
+
+    return DLLIST_NONE;
+}
+
+// Address space for max_cpcty slots, none of it usable until committed. 
+// It is not charged against memory until then either
+static dllist_err_t dllist_vm_reserve_(dllist_t* dllist, ssize_t max_cpcty)
+{
+    utils_assert(dllist);
+    utils_assert(max_cpcty > 0);
+
+    if(max_cpcty > DLLIST_IDX_MAX_ || (size_t) max_cpcty > SIZE_MAX / DLLIST_NODE_SIZE_)
+        return DLLIST_CPCTY_OVERFLOW;
+
+    void* block = mmap(NULL, (size_t) max_cpcty * DLLIST_NODE_SIZE_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if(block == MAP_FAILED)
+        return DLLIST_ALLOC_FAIL;
+
+    dllist->max_cpcty = max_cpcty;
+
+    dllist_carve_(dllist, block, max_cpcty);
+
+    return DLLIST_NONE;
+}
+
+// Growth makes the pages under the new slots of every array writable, 
+// shrinking drops the pages no slot below nw_cpcty lies in; no node moves 
+// either way. A page shared by two arrays is only ever committed
+static dllist_err_t dllist_vm_commit_(dllist_t* dllist, ssize_t nw_cpcty)
+{
+    utils_assert(dllist);
+    utils_assert(dllist->max_cpcty);
+
+    uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+
+#ifdef DLLIST_AOS
+    char*  arrs[]  = {(char*) dllist->node};
+    size_t sizes[] = {sizeof(dllist_node_t)};
+#else // DLLIST_AOS
+    char*  arrs[]  = {(char*) dllist->next, (char*) dllist->prev, (char*) dllist->data};
+    size_t sizes[] = {sizeof(dllist_idx_t), sizeof(dllist_idx_t), sizeof(dllist_data_t)};
+#endif // DLLIST_AOS
+
+    for(size_t k = 0; k < sizeof(arrs) / sizeof(arrs[0]); ++k) {
+        uintptr_t old_end = (uintptr_t) (arrs[k] + (size_t) dllist->cpcty * sizes[k]);
+        uintptr_t end     = (uintptr_t) (arrs[k] + (size_t) nw_cpcty      * sizes[k]);
+
+        if(nw_cpcty > dllist->cpcty) {
+            uintptr_t lo = old_end / page * page;
+            uintptr_t hi = (end + page - 1) / page * page;
+
+            if(mprotect((void*) lo, hi - lo, PROT_READ | PROT_WRITE) != 0)
+                return DLLIST_ALLOC_FAIL;
+        }
+        else {
+            uintptr_t lo = (end + page - 1) / page * page;
+            uintptr_t hi = old_end / page * page;
+
+            if(lo < hi) {
+                (void) madvise((void*) lo, hi - lo, MADV_DONTNEED);
+                (void) mprotect((void*) lo, hi - lo, PROT_NONE);
+            }
+        }
+    }
+
+    dllist->cpcty = nw_cpcty;
+
+    return DLLIST_NONE;
+}
+
+// The capacity the growth policy asks for, kept from overflowing
+static ssize_t dllist_grow_cpcty_(const dllist_t* dllist, ssize_t min_cpcty)
+{
+    const dllist_growth_t* growth = &dllist->growth;
+
+    ssize_t cpcty = dllist->cpcty;
+
+    if(growth->grow)
+        return growth->grow(cpcty, min_cpcty, growth->ctx);
+
+    ssize_t step = growth->step;
+
+    if(!step && growth->factor <= 1 && dllist->max_cpcty)
+        step = DLLIST_SEGMENT_;
+
+    if(step)
+        return cpcty > DLLIST_IDX_MAX_ - step ? DLLIST_IDX_MAX_ : cpcty + step;
+
+    double factor = growth->factor > 1 ? growth->factor : 2;
+
+    if((double) cpcty * factor >= (double) DLLIST_IDX_MAX_)
+        return DLLIST_IDX_MAX_;
+
+    return (ssize_t) ((double) cpcty * factor);
+}
+
+static dllist_err_t dllist_grow_(dllist_t* dllist, ssize_t min_cpcty)
+{
+    utils_assert(dllist);
+    utils_assert(min_cpcty > dllist->cpcty);
+
+    ssize_t nw_cpcty = dllist_grow_cpcty_(dllist, min_cpcty);
+
+    if(dllist->max_cpcty && nw_cpcty > dllist->max_cpcty)
+        nw_cpcty = dllist->max_cpcty;
+
+    if(nw_cpcty < min_cpcty)
+        nw_cpcty = min_cpcty;
+
+    return dllist_realloc_(dllist, nw_cpcty);
+}
+
+// Recycled slots come from the free list, fresh ones are bumped off the 
+// high-water mark and are never written before they are handed out
+static dllist_err_t dllist_take_slot_(dllist_t* dllist, ssize_t* slot)
+{
+    utils_assert(dllist);
+    utils_assert(slot);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    if(dllist->free != DLLIST_NULL_) {
+        *slot        = dllist->free;
+        dllist->free = DLLIST_NEXT(dllist, *slot);
+
+        return DLLIST_NONE;
+    }
+
+    // during a compaction cycle the lowest hole goes first
+    if(dllist->compact) {
+        *slot = dllist_compact_hole_(dllist);
+
+        if(*slot != DLLIST_NULL_) {
+            dllist->compact[*slot / 64] &= ~(1ull << (*slot % 64));
+            return DLLIST_NONE;
+        }
+    }
+
+    if(dllist->freemap) {
+        *slot = dllist_bitmap_lowest_(dllist->freemap, &dllist->freemap_lo, dllist->hwm);
+
+        if(*slot != DLLIST_NULL_) {
+            dllist->freemap[*slot / 64] &= ~(1ull << (*slot % 64));
+            return DLLIST_NONE;
+        }
+    }
+
+    if(dllist->hwm == dllist->cpcty) {
+        err = dllist_grow_(dllist, dllist->cpcty + 1);
+        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    }
+
+    *slot = dllist->hwm++;
+
+    return DLLIST_NONE;
+}
+
+// With dllist_near_enable the free slot closest to `after` is taken, 
+// so list neighbours stay neighbours in memory; any other one otherwise
+static dllist_err_t dllist_take_slot_near_(dllist_t* dllist, ssize_t after, ssize_t* slot)
+{
+    utils_assert(dllist);
+    utils_assert(slot);
+
+    if(dllist->freemap) {
+        // a compaction cycle has the free slots in its own bitmap
+        uint64_t* map = dllist->compact ? dllist->compact : dllist->freemap;
+
+        *slot = dllist_bitmap_near_(map, after, dllist->hwm);
+
+        if(*slot != DLLIST_NULL_) {
+            map[*slot / 64] &= ~(1ull << (*slot % 64));
+            return DLLIST_NONE;
+        }
+    }
+
+    return dllist_take_slot_(dllist, slot);
+}
+
+dllist_err_t dllist_insert_after(dllist_t* dllist, dllist_data_t val, ssize_t after)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    IF_DEBUG(
+        if(after >= dllist->hwm)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else if(after < DLLIST_NULL_)
+            err = DLLIST_OUT_OF_BOUND;
+
+        if(err != DLLIST_NONE) {
+            DLLIST_DUMP_(dllist, err);
+            return err;
+        }
+    )
+    
+    err = dllist_hash_reserve_(dllist, 1);
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    ssize_t cur = DLLIST_NULL_;
+
+    err = dllist_take_slot_near_(dllist, after, &cur);
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    DLLIST_DATA(dllist, cur) = val;
+
+    dllist->is_linear = 
+        dllist->is_linear 
+        && after == DLLIST_PREV(dllist, DLLIST_NULL_) 
+        && cur == dllist->size + 1;
+
+    DLLIST_NEXT(dllist, cur)                        = DLLIST_NEXT(dllist, after);
+    DLLIST_PREV(dllist, cur)                        = DLLIST_IDX_(after);
+    DLLIST_PREV(dllist, DLLIST_NEXT(dllist, after)) = DLLIST_IDX_(cur);
+    DLLIST_NEXT(dllist, after)                      = DLLIST_IDX_(cur);
+
+    ++dllist->size;
+
+    dllist_index_link_(dllist, cur, after);
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+
+// The values go into one run of never-used slots above the high-water 
+// mark, linked in order and spliced in after `after` as a whole
+dllist_err_t dllist_insert_range_after(dllist_t* dllist, const dllist_data_t* vals, ssize_t n, ssize_t after)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    utils_assert(vals || n == 0);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    IF_DEBUG(
+        if(after >= dllist->hwm)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else if(after < DLLIST_NULL_)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else if(n < 0)
+            err = DLLIST_BAD_SIZE;
+
+        if(err != DLLIST_NONE) {
+            DLLIST_DUMP_(dllist, err);
+            return err;
+        }
+    )
+
+    if(n <= 0)
+        return DLLIST_NONE;
+
+    err = dllist_reserve_run_(dllist, n);
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+#ifdef DLLIST_AOS
+    for(ssize_t i = 0; i < n; ++i)
+        DLLIST_DATA(dllist, dllist->hwm + i) = vals[i];
+#else // DLLIST_AOS
+    memcpy(&DLLIST_DATA(dllist, dllist->hwm), vals, sizeof(vals[0]) * (size_t) n);
+#endif // DLLIST_AOS
+
+    dllist_link_run_(dllist, n, after);
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+static dllist_err_t dllist_reserve_run_(dllist_t* dllist, ssize_t n)
+{
+    dllist_err_t err = dllist_hash_reserve_(dllist, n);
+
+    if(err != DLLIST_NONE || dllist->cpcty - dllist->hwm >= n)
+        return err;
+
+    return dllist_grow_(dllist, dllist->hwm + n);
+}
+
+// Links the n filled slots starting at the high-water mark in order and 
+// splices them in after `after`
+static void dllist_link_run_(dllist_t* dllist, ssize_t n, ssize_t after)
+{
+    ssize_t first = dllist->hwm;
+    ssize_t last  = first + n - 1;
+
+    for(ssize_t i = first; i <= last; ++i)
+        DLLIST_NEXT(dllist, i) = DLLIST_IDX_(i + 1);
+
+    for(ssize_t i = first; i <= last; ++i)
+        DLLIST_PREV(dllist, i) = DLLIST_IDX_(i - 1);
+
+    dllist->is_linear = 
+        dllist->is_linear 
+        && after == DLLIST_PREV(dllist, DLLIST_NULL_) 
+        && first == dllist->size + 1;
+
+    DLLIST_NEXT(dllist, last)                       = DLLIST_NEXT(dllist, after);
+    DLLIST_PREV(dllist, first)                      = DLLIST_IDX_(after);
+    DLLIST_PREV(dllist, DLLIST_NEXT(dllist, after)) = DLLIST_IDX_(last);
+    DLLIST_NEXT(dllist, after)                      = DLLIST_IDX_(first);
+
+    dllist->hwm  += n;
+    dllist->size += n;
+
+    for(ssize_t i = first; i <= last; ++i)
+        dllist_index_link_(dllist, i, i == first ? after : i - 1);
+}
+
+dllist_err_t dllist_from_array(dllist_t* dllist, const dllist_data_t* vals, ssize_t n, char* log_filename)
+{
+    utils_assert(dllist);
+    utils_assert(n >= 0);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    err = dllist_ctor(dllist, n + 1, log_filename);
+    if(err != DLLIST_NONE)
+        return err;
+
+    return dllist_insert_range_after(dllist, vals, n, DLLIST_NULL_);
+}
+
+dllist_err_t dllist_delete_at(dllist_t* dllist, ssize_t at)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    IF_DEBUG(
+        if(at >= dllist->hwm)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else if(at <= DLLIST_NULL_)
+            err = DLLIST_OUT_OF_BOUND;
+
+        if(err != DLLIST_NONE) {
+            DLLIST_DUMP_(dllist, err);
+            return err;
+        }
+    )
+
+    dllist_unlink_(dllist, at);
+
+    dllist_compact_auto_(dllist);
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+static void dllist_unlink_(dllist_t* dllist, ssize_t at)
+{
+    dllist_index_unlink_(dllist, at);
+
+    dllist->is_linear = 
+        dllist->is_linear 
+        && at == DLLIST_PREV(dllist, DLLIST_NULL_);
+
+    DLLIST_NEXT(dllist, DLLIST_PREV(dllist, at)) = DLLIST_NEXT(dllist, at);
+    DLLIST_PREV(dllist, DLLIST_NEXT(dllist, at)) = DLLIST_PREV(dllist, at);
+
+    dllist_free_slot_(dllist, at);
+
+    --dllist->size;
+}
+
+// The nodes from first to last are already chained by next, so after 
+// marking them free the whole run is pushed onto the free list at once
+dllist_err_t dllist_erase_range(dllist_t* dllist, ssize_t first, ssize_t last)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    IF_DEBUG(
+        dllist_err_t err = DLLIST_NONE; 
+
+        if(first >= dllist->hwm || last >= dllist->hwm)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else if(first <= DLLIST_NULL_ || last <= DLLIST_NULL_)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else {
+            ssize_t ind = first;
+
+            while(ind != last && ind != DLLIST_NULL_)
+                ind = DLLIST_NEXT(dllist, ind);
+
+            if(ind != last)
+                err = DLLIST_OUT_OF_BOUND;
+        }
+
+        if(err != DLLIST_NONE) {
+            DLLIST_DUMP_(dllist, err);
+            return err;
+        }
+    )
+
+    ssize_t before = DLLIST_PREV(dllist, first);
+    ssize_t after  = DLLIST_NEXT(dllist, last);
+    ssize_t cnt    = 0;
+
+    for(ssize_t ind = first; ; ind = DLLIST_NEXT(dllist, ind)) {
+        dllist_index_unlink_(dllist, ind);
+
+        DLLIST_PREV(dllist, ind) = DLLIST_IDX_(DLLIST_NONE_);
+        ++cnt;
+
+        if(ind == last)
+            break;
+    }
+
+    dllist->is_linear = 
+        dllist->is_linear 
+        && after == DLLIST_NULL_;
+
+    DLLIST_NEXT(dllist, before) = DLLIST_IDX_(after);
+    DLLIST_PREV(dllist, after)  = DLLIST_IDX_(before);
+
+    if(dllist->compact || dllist->freemap) {
+        for(ssize_t ind = first, nxt = DLLIST_NULL_; ind != DLLIST_NULL_; ind = nxt) {
+            nxt = ind == last ? DLLIST_NULL_ : DLLIST_NEXT(dllist, ind);
+            dllist_free_slot_(dllist, ind);
+        }
+    }
+    else {
+        DLLIST_NEXT(dllist, last) = DLLIST_IDX_(dllist->free);
+        dllist->free              = first;
+    }
+
+    dllist->size -= cnt;
+
+    dllist_compact_auto_(dllist);
+
+    DLLIST_DUMP_(dllist, DLLIST_NONE);
+
+    return DLLIST_NONE;
+}
+
+dllist_err_t dllist_remove_if(dllist_t* dllist, dllist_pred_t pred, void* ctx)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    utils_assert(pred);
+
+    ssize_t ind = DLLIST_NEXT(dllist, DLLIST_NULL_);
+
+    while(ind != DLLIST_NULL_) {
+        ssize_t nxt = DLLIST_NEXT(dllist, ind);
+
+        if(pred(DLLIST_DATA(dllist, ind), ctx))
+            dllist_unlink_(dllist, ind);
+
+        ind = nxt;
+    }
+
+    dllist_compact_auto_(dllist);
+
+    DLLIST_DUMP_(dllist, DLLIST_NONE);
+
+    return DLLIST_NONE;
+}
+
+dllist_err_t dllist_remove_value(dllist_t* dllist, dllist_data_t val)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    ssize_t ind = DLLIST_NEXT(dllist, DLLIST_NULL_);
+
+    while(ind != DLLIST_NULL_) {
+        ssize_t nxt = DLLIST_NEXT(dllist, ind);
+
+        if(DLLIST_DATA(dllist, ind) == val)
+            dllist_unlink_(dllist, ind);
+
+        ind = nxt;
+    }
+
+    dllist_compact_auto_(dllist);
+
+    DLLIST_DUMP_(dllist, DLLIST_NONE);
+
+    return DLLIST_NONE;
+}
+
+// Linearization is done in place: every slot gets its target position 
+// stored in prev, then the slots are permuted by following the cycles 
+// of that permutation, so no second copy of the storage is needed and 
+// the capacity is kept
+dllist_err_t dllist_linearize(dllist_t* dllist)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    ssize_t rank = DLLIST_NULL_ + 1;
+    ssize_t ind  = DLLIST_NEXT(dllist, DLLIST_NULL_);
+
+    while(ind != DLLIST_NULL_) {
+        ssize_t nxt = DLLIST_NEXT(dllist, ind);
+
+        DLLIST_PREV(dllist, ind) = DLLIST_IDX_(rank++);
+        ind = nxt;
+    }
+
+    // free slots are moved behind the last element
+    for(ssize_t i = DLLIST_NULL_ + 1; i < dllist->hwm; ++i)
+        if(DLLIST_PREV(dllist, i) == DLLIST_NONE_)
+            DLLIST_PREV(dllist, i) = DLLIST_IDX_(rank++);
+
+    for(ssize_t i = DLLIST_NULL_ + 1; i < dllist->hwm; ++i) {
+        while(DLLIST_PREV(dllist, i) != i) {
+            ssize_t dst = DLLIST_PREV(dllist, i);
+
+            dllist_data_t data_tmp   = DLLIST_DATA(dllist, dst);
+            DLLIST_DATA(dllist, dst) = DLLIST_DATA(dllist, i);
+            DLLIST_DATA(dllist, i)   = data_tmp;
+
+            DLLIST_PREV(dllist, i)   = DLLIST_PREV(dllist, dst);
+            DLLIST_PREV(dllist, dst) = DLLIST_IDX_(dst);
+        }
+    }
+
+    for(ssize_t i = DLLIST_NULL_; i <= dllist->size; ++i) {
+        DLLIST_NEXT(dllist, i) = DLLIST_IDX_(i + 1);
+        DLLIST_PREV(dllist, i) = DLLIST_IDX_(i - 1);
+    }
+
+    DLLIST_NEXT(dllist, dllist->size) = DLLIST_NULL_;
+    DLLIST_PREV(dllist, DLLIST_NULL_) = DLLIST_IDX_(dllist->size);
+
+    dllist->hwm       = dllist->size + 1;
+    dllist->free      = DLLIST_NULL_;
+    dllist->is_linear = 1;
+
+    dllist_compact_end_(dllist);
+    dllist_freemap_clear_(dllist);
+    dllist_map_advise_(dllist);
+
+    dllist_index_rebuild_(dllist);
+
+    DLLIST_DUMP_(dllist, DLLIST_NONE);
+
+    return DLLIST_NONE;
+}
+
+// Stable. With a comparator the list is merge sorted bottom-up on next 
+// alone: bin k holds a sorted run of 2^k nodes, each node is merged up 
+// through the full bins like a carry, and prev is rebuilt at the end. 
+// Without one the values are ordered as integers by an LSD radix sort
+dllist_err_t dllist_sort(dllist_t* dllist, dllist_cmp_t cmp, void* ctx, int linearize)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    if(!cmp) {
+        err = dllist_radix_sort_(dllist, linearize);
+        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+        DLLIST_DUMP_(dllist, err);
+
+        return DLLIST_NONE;
+    }
+
+    // a bin per bit of the size, bins higher up hold earlier nodes
+    ssize_t bin[sizeof(ssize_t) * CHAR_BIT] = {};
+    ssize_t ind = DLLIST_NEXT(dllist, DLLIST_NULL_);
+
+    while(ind != DLLIST_NULL_) {
+        ssize_t nxt = DLLIST_NEXT(dllist, ind);
+        ssize_t run = ind;
+        size_t  k   = 0;
+
+        DLLIST_NEXT(dllist, ind) = DLLIST_NULL_;
+
+        for(; bin[k] != DLLIST_NULL_; ++k) {
+            run    = dllist_sort_merge_(dllist, bin[k], run, cmp, ctx);
+            bin[k] = DLLIST_NULL_;
+        }
+
+        bin[k] = run;
+        ind    = nxt;
+    }
+
+    ssize_t head = DLLIST_NULL_;
+
+    for(size_t k = 0; k < sizeof(bin) / sizeof(bin[0]); ++k)
+        if(bin[k] != DLLIST_NULL_)
+            head = head == DLLIST_NULL_ ? bin[k] : dllist_sort_merge_(dllist, bin[k], head, cmp, ctx);
+
+    DLLIST_NEXT(dllist, DLLIST_NULL_) = DLLIST_IDX_(head);
+
+    dllist_sort_relink_(dllist);
+    dllist_order_rebuild_(dllist);
+
+    if(linearize)
+        return dllist_linearize(dllist);
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// Merges two runs chained by next and ended by DLLIST_NULL_, the 
+// sentinel's next serving as the head of the result; on ties lhs wins
+static ssize_t dllist_sort_merge_(dllist_t* dllist, ssize_t lhs, ssize_t rhs, dllist_cmp_t cmp, void* ctx)
+{
+    ssize_t tail = DLLIST_NULL_;
+
+    while(lhs != DLLIST_NULL_ && rhs != DLLIST_NULL_) {
+        if(cmp(DLLIST_DATA(dllist, rhs), DLLIST_DATA(dllist, lhs), ctx) < 0) {
+            DLLIST_NEXT(dllist, tail) = DLLIST_IDX_(rhs);
+            tail = rhs;
+            rhs  = DLLIST_NEXT(dllist, rhs);
+        }
+        else {
+            DLLIST_NEXT(dllist, tail) = DLLIST_IDX_(lhs);
+            tail = lhs;
+            lhs  = DLLIST_NEXT(dllist, lhs);
+        }
+    }
+
+    DLLIST_NEXT(dllist, tail) = DLLIST_IDX_(lhs != DLLIST_NULL_ ? lhs : rhs);
+
+    return DLLIST_NEXT(dllist, DLLIST_NULL_);
+}
+
+// prev from next, next being a chain from the sentinel ended by it
+static void dllist_sort_relink_(dllist_t* dllist)
+{
+    ssize_t prv = DLLIST_NULL_;
+
+    for(ssize_t ind = DLLIST_NEXT(dllist, DLLIST_NULL_); ind != DLLIST_NULL_; ind = DLLIST_NEXT(dllist, ind)) {
+        DLLIST_PREV(dllist, ind) = DLLIST_IDX_(prv);
+        prv = ind;
+    }
+
+    DLLIST_PREV(dllist, DLLIST_NULL_) = DLLIST_IDX_(prv);
+
+    dllist->is_linear = dllist->size == 0;
+}
+
+// Keys are the values with the sign bit flipped, so that they order as 
+// unsigned. Linearizing writes the sorted values straight into slots 
+// 1..size; otherwise the slots are sorted along with their keys and the 
+// list is relinked in that order
+static dllist_err_t dllist_radix_sort_(dllist_t* dllist, int linearize)
+{
+    static_assert(sizeof(dllist_data_t) == sizeof(uint32_t), "radix keys are 32-bit");
+
+    const uint32_t SIGN = 1u << 31;
+
+    ssize_t n = dllist->size;
+
+    uint32_t*     key  = (uint32_t*) calloc((size_t) n * 2 + 1, sizeof(uint32_t));
+    dllist_idx_t* slot = linearize ? NULL : (dllist_idx_t*) calloc((size_t) n * 2 + 1, sizeof(dllist_idx_t));
+
+    if(!key || (!linearize && !slot)) {
+        free(key);
+        free(slot);
+
+        return DLLIST_ALLOC_FAIL;
+    }
+
+    // list order in, so equal values keep it
+    ssize_t cnt = 0;
+
+    DLLIST_FOR_EACH(dllist, ind) {
+        key[cnt] = (uint32_t) DLLIST_DATA(dllist, ind) ^ SIGN;
+
+        if(slot)
+            slot[cnt] = DLLIST_IDX_(ind);
+
+        ++cnt;
+    }
+
+    uint32_t*     key_out  = key + n;
+    dllist_idx_t* slot_out = slot ? slot + n : NULL;
+
+    for(int shift = 0; shift < 32; shift += 8) {
+        if(!dllist_radix_pass_(key, slot, key_out, slot_out, n, shift))
+            continue;
+
+        uint32_t* key_tmp = key;
+        key     = key_out;
+        key_out = key_tmp;
+
+        dllist_idx_t* slot_tmp = slot;
+        slot     = slot_out;
+        slot_out = slot_tmp;
+    }
+
+    if(linearize) {
+        for(ssize_t i = 0; i < n; ++i)
+            DLLIST_DATA(dllist, i + 1) = (dllist_data_t) (key[i] ^ SIGN);
+
+        for(ssize_t i = DLLIST_NULL_; i <= n; ++i) {
+            DLLIST_NEXT(dllist, i) = DLLIST_IDX_(i + 1);
+            DLLIST_PREV(dllist, i) = DLLIST_IDX_(i - 1);
+        }
+
+        DLLIST_NEXT(dllist, n)            = DLLIST_NULL_;
+        DLLIST_PREV(dllist, DLLIST_NULL_) = DLLIST_IDX_(n);
+
+        dllist->hwm       = n + 1;
+        dllist->free      = DLLIST_NULL_;
+        dllist->is_linear = 1;
+
+        dllist_compact_end_(dllist);
+        dllist_freemap_clear_(dllist);
+        dllist_map_advise_(dllist);
+
+        dllist_index_rebuild_(dllist);
+    }
+    else {
+        ssize_t prv = DLLIST_NULL_;
+
+        for(ssize_t i = 0; i < n; ++i) {
+            DLLIST_NEXT(dllist, prv) = slot[i];
+            prv = slot[i];
+        }
+
+        DLLIST_NEXT(dllist, prv) = DLLIST_NULL_;
+
+        dllist_sort_relink_(dllist);
+        dllist_order_rebuild_(dllist);
+    }
+
+    // the buffers may have been swapped, the lower half owns each block
+    free(key < key_out ? key : key_out);
+    free(slot && slot < slot_out ? slot : slot_out);
+
+    return DLLIST_NONE;
+}
+
+// One stable counting pass on the byte at shift; a byte shared by every 
+// key sorts nothing and the pass is skipped, returning 0
+static int dllist_radix_pass_(const uint32_t* key, const dllist_idx_t* slot, uint32_t* key_out, dllist_idx_t* slot_out, ssize_t n, int shift)
+{
+    ssize_t cnt[256] = {};
+
+    for(ssize_t i = 0; i < n; ++i)
+        ++cnt[(key[i] >> shift) & 0xFF];
+
+    if(n == 0 || cnt[(key[0] >> shift) & 0xFF] == n)
+        return 0;
+
+    ssize_t sum = 0;
+
+    for(int b = 0; b < 256; ++b) {
+        ssize_t c = cnt[b];
+        cnt[b] = sum;
+        sum += c;
+    }
+
+    for(ssize_t i = 0; i < n; ++i) {
+        ssize_t dst = cnt[(key[i] >> shift) & 0xFF]++;
+
+        key_out[dst] = key[i];
+
+        if(slot)
+            slot_out[dst] = slot[i];
+    }
+
+    return 1;
+}
+
+// The head always starts sublist 0, the others start at live slots 
+// picked at random, duplicates and free slots skipped. Sublists past the 
+// first are sorted by head for dllist_rank_find_
+static ssize_t dllist_rank_split_(dllist_t* dllist, uint64_t* mark, dllist_rank_sub_t_* sub, ssize_t nsub)
+{
+    ssize_t  cnt = 0;
+    uint64_t rnd = (uint64_t) dllist->hwm;
+
+    for(ssize_t i = 0; i < nsub * 4 && cnt < nsub; ++i) {
+        ssize_t head = DLLIST_NEXT(dllist, DLLIST_NULL_);
+
+        if(i > 0) {
+            rnd  = dllist_order_prio_((ssize_t) rnd);
+            head = DLLIST_NULL_ + 1 + (ssize_t) (rnd % (uint64_t) (dllist->hwm - 1));
+        }
+
+        if(DLLIST_PREV(dllist, head) == DLLIST_NONE_ || DLLIST_RANK_MARKED_(mark, head))
+            continue;
+
+        mark[head / 64] |= 1ull << (head % 64);
+        sub[cnt++].head = head;
+    }
+
+    if(cnt > 1)
+        qsort(sub + 1, (size_t) cnt - 1, sizeof(sub[0]), dllist_rank_cmp_);
+
+    return cnt;
+}
+
+static int dllist_rank_cmp_(const void* lhs, const void* rhs)
+{
+    ssize_t lhead = ((const dllist_rank_sub_t_*) lhs)->head;
+    ssize_t rhead = ((const dllist_rank_sub_t_*) rhs)->head;
+
+    return (lhead > rhead) - (lhead < rhead);
+}
+
+// Sublist starting at head, which must be a splitter
+static ssize_t dllist_rank_find_(const dllist_rank_sub_t_* sub, ssize_t nsub, ssize_t head)
+{
+    if(sub[0].head == head)
+        return 0;
+
+    ssize_t lo = 1;
+    ssize_t hi = nsub;
+
+    while(hi - lo > 1) {
+        ssize_t mid = lo + (hi - lo) / 2;
+
+        if(sub[mid].head <= head)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    utils_assert(sub[lo].head == head);
+
+    return lo;
+}
+
+// List ranking after Helman and JaJa: random splitters cut the list 
+// into sublists that are walked in parallel, each node getting its rank 
+// within its sublist in prev and its sublist in next. A serial pass over 
+// the sublists turns that into positions, the data is scattered by 
+// position into a scratch array and copied back while the links are 
+// rewritten. Unlike dllist_linearize this needs a second copy of data
+dllist_err_t dllist_linearize_parallel(dllist_t* dllist, dllist_pool_t* pool)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    if(!pool || pool->nthreads < 2 || dllist->size < DLLIST_PARALLEL_MIN_)
+        return dllist_linearize(dllist);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    ssize_t nsub = pool->nthreads * DLLIST_RANK_SUBS_PER_WORKER_;
+
+    dllist_rank_ctx_t_ ctx = {
+        .dllist  = dllist,
+        .mark    = (uint64_t*) calloc((size_t) dllist->hwm / 64 + 1, sizeof(uint64_t)),
+        .sub     = (dllist_rank_sub_t_*) calloc((size_t) nsub, sizeof(dllist_rank_sub_t_)),
+        .nsub    = 0,
+        .taken   = 0,
+        .scratch = (dllist_data_t*) calloc((size_t) dllist->size + 1, sizeof(dllist_data_t))
+    };
+
+    if(!ctx.mark || !ctx.sub || !ctx.scratch) {
+        free(ctx.mark);
+        free(ctx.sub);
+        free(ctx.scratch);
+
+        err = DLLIST_ALLOC_FAIL;
+        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    }
+
+    ctx.nsub = dllist_rank_split_(dllist, ctx.mark, ctx.sub, nsub);
+
+    dllist_pool_run(pool, dllist_rank_walk_job_, &ctx);
+
+    // a walk stops at the head of the next sublist, whose next now holds 
+    // that sublist's number
+    for(ssize_t i = 0; i < ctx.nsub; ++i)
+        if(ctx.sub[i].succ != DLLIST_NULL_)
+            ctx.sub[i].succ = DLLIST_NEXT(dllist, ctx.sub[i].succ);
+        else
+            ctx.sub[i].succ = -1;
+
+    ssize_t pos = DLLIST_NULL_ + 1;
+
+    for(ssize_t i = 0; i != -1; i = ctx.sub[i].succ) {
+        ctx.sub[i].off = pos;
+        pos += ctx.sub[i].len;
+    }
+
+    utils_assert(pos == dllist->size + 1);
+
+    dllist_pool_run(pool, dllist_rank_scatter_job_, &ctx);
+    dllist_pool_run(pool, dllist_rank_relink_job_, &ctx);
+
+    DLLIST_NEXT(dllist, DLLIST_NULL_) = DLLIST_IDX_(DLLIST_NULL_ + 1);
+    DLLIST_PREV(dllist, DLLIST_NULL_) = DLLIST_IDX_(dllist->size);
+    DLLIST_NEXT(dllist, dllist->size) = DLLIST_NULL_;
+
+    dllist->hwm       = dllist->size + 1;
+    dllist->free      = DLLIST_NULL_;
+    dllist->is_linear = 1;
+
+    dllist_compact_end_(dllist);
+    dllist_freemap_clear_(dllist);
+    dllist_map_advise_(dllist);
+
+    NFREE(ctx.mark);
+    NFREE(ctx.sub);
+    NFREE(ctx.scratch);
+
+    dllist_index_rebuild_(dllist);
+
+    DLLIST_DUMP_(dllist, DLLIST_NONE);
+
+    return DLLIST_NONE;
+}
+
+// Sublists are taken one at a time, so a worker that drew short ones 
+// takes more
+static void dllist_rank_walk_job_(void* arg, int worker, int nworkers)
+{
+    (void) worker;
+    (void) nworkers;
+
+    dllist_rank_ctx_t_* ctx    = (dllist_rank_ctx_t_*) arg;
+    dllist_t*           dllist = ctx->dllist;
+
+    for(;;) {
+        ssize_t i = __atomic_fetch_add(&ctx->taken, 1, __ATOMIC_RELAXED);
+
+        if(i >= ctx->nsub)
+            return;
+
+        ssize_t ind = ctx->sub[i].head;
+        ssize_t len = 0;
+        ssize_t nxt = DLLIST_NULL_;
+
+        for(;;) {
+            nxt = DLLIST_NEXT(dllist, ind);
+
+            DLLIST_PREV(dllist, ind) = DLLIST_IDX_(len++);
+            DLLIST_NEXT(dllist, ind) = DLLIST_IDX_(i);
+
+            if(nxt == DLLIST_NULL_ || DLLIST_RANK_MARKED_(ctx->mark, nxt))
+                break;
+
+            ind = nxt;
+        }
+
+        ctx->sub[i].len  = len;
+        ctx->sub[i].succ = nxt;
+    }
+}
+
+static void dllist_rank_scatter_job_(void* arg, int worker, int nworkers)
+{
+    dllist_rank_ctx_t_* ctx    = (dllist_rank_ctx_t_*) arg;
+    dllist_t*           dllist = ctx->dllist;
+
+    ssize_t n  = dllist->hwm - (DLLIST_NULL_ + 1);
+    ssize_t lo = DLLIST_NULL_ + 1 + DLLIST_POOL_LO(n, worker, nworkers);
+    ssize_t hi = DLLIST_NULL_ + 1 + DLLIST_POOL_HI(n, worker, nworkers);
+
+    for(ssize_t i = lo; i < hi; ++i) {
+        ssize_t rank = DLLIST_PREV(dllist, i);
+
+        if(rank != DLLIST_NONE_)
+            ctx->scratch[ctx->sub[DLLIST_NEXT(dllist, i)].off + rank] = DLLIST_DATA(dllist, i);
+    }
+}
+
+static void dllist_rank_relink_job_(void* arg, int worker, int nworkers)
+{
+    dllist_rank_ctx_t_* ctx    = (dllist_rank_ctx_t_*) arg;
+    dllist_t*           dllist = ctx->dllist;
+
+    ssize_t lo = DLLIST_NULL_ + 1 + DLLIST_POOL_LO(dllist->size, worker, nworkers);
+    ssize_t hi = DLLIST_NULL_ + 1 + DLLIST_POOL_HI(dllist->size, worker, nworkers);
+
+    for(ssize_t i = lo; i < hi; ++i) {
+        DLLIST_DATA(dllist, i) = ctx->scratch[i];
+        DLLIST_NEXT(dllist, i) = DLLIST_IDX_(i + 1);
+        DLLIST_PREV(dllist, i) = DLLIST_IDX_(i - 1);
+    }
+}
+
+// visit may change the values, the hash index is rebuilt afterwards
+dllist_err_t dllist_parallel_for_each(dllist_t* dllist, dllist_pool_t* pool, dllist_walk_t walk, dllist_visit_t visit, void* ctx)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    utils_assert(visit);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    dllist_walk_ctx_t_ wctx = {};
+
+    wctx.dllist = dllist;
+    wctx.visit  = visit;
+    wctx.ctx    = ctx;
+
+    // every element may come out of visit with a value of its own
+    if(dllist->hash) {
+        int bits = dllist->hash->bits;
+
+        while(((ssize_t) 1 << bits) < dllist->size * 2)
+            ++bits;
+
+        if(bits != dllist->hash->bits)
+            err = dllist_hash_rehash_(dllist->hash, bits);
+        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    }
+
+    err = dllist_walk_(dllist, pool, walk, &wctx, NULL, NULL);
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    dllist_hash_rebuild_(dllist);
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// Every unit of work folds from init and the partials are combined 
+// from init as well, so init must be the identity of combine
+dllist_err_t dllist_parallel_reduce(dllist_t* dllist, dllist_pool_t* pool, dllist_walk_t walk, int64_t init, dllist_fold_t fold, dllist_combine_t combine, void* ctx, int64_t* res)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    utils_assert(fold);
+    utils_assert(combine);
+    utils_assert(res);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    dllist_walk_ctx_t_ wctx = {};
+
+    wctx.dllist = dllist;
+    wctx.fold   = fold;
+    wctx.init   = init;
+    wctx.ctx    = ctx;
+
+    err = dllist_walk_(dllist, pool, walk, &wctx, combine, res);
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// A linear list is in slot order already, so only a non-linear one 
+// walked in list order is cut into sublists; everything else is cut 
+// into chunks of slots. Units go to workers through dllist_pool_for
+static dllist_err_t dllist_walk_(dllist_t* dllist, dllist_pool_t* pool, dllist_walk_t walk, dllist_walk_ctx_t_* wctx, dllist_combine_t combine, int64_t* res)
+{
+    if(!pool || pool->nthreads < 2 || dllist->size < DLLIST_PARALLEL_MIN_) {
+        int64_t acc = wctx->init;
+
+        if(walk == DLLIST_WALK_LIST) {
+            DLLIST_FOR_EACH(dllist, ind)
+                acc = dllist_walk_one_(wctx, ind, acc);
+        }
+        else {
+            for(ssize_t ind = DLLIST_NULL_ + 1; ind < dllist->hwm; ++ind)
+                if(DLLIST_PREV(dllist, ind) != DLLIST_NONE_)
+                    acc = dllist_walk_one_(wctx, ind, acc);
+        }
+
+        if(res)
+            *res = acc;
+
+        return DLLIST_NONE;
+    }
+
+    ssize_t nunit = (dllist->hwm + DLLIST_PARALLEL_CHUNK_ - 1) / DLLIST_PARALLEL_CHUNK_;
+
+    if(walk == DLLIST_WALK_LIST && !dllist->is_linear) {
+        wctx->nsub = pool->nthreads * DLLIST_RANK_SUBS_PER_WORKER_;
+        wctx->mark = (uint64_t*) calloc((size_t) dllist->hwm / 64 + 1, sizeof(uint64_t));
+        wctx->sub  = (dllist_rank_sub_t_*) calloc((size_t) wctx->nsub, sizeof(dllist_rank_sub_t_));
+    }
+
+    wctx->partial = (int64_t*) calloc((size_t) (wctx->sub ? wctx->nsub : nunit), sizeof(int64_t));
+
+    if(!wctx->partial || (wctx->nsub && (!wctx->mark || !wctx->sub))) {
+        NFREE(wctx->partial);
+        NFREE(wctx->mark);
+        NFREE(wctx->sub);
+
+        return DLLIST_ALLOC_FAIL;
+    }
+
+    if(wctx->sub) {
+        wctx->nsub = dllist_rank_split_(dllist, wctx->mark, wctx->sub, wctx->nsub);
+        nunit      = wctx->nsub;
+    }
+
+    dllist_pool_for(pool, nunit, 1, dllist_walk_body_, wctx);
+
+    // a sublist walk stops at the head of the one that follows it
+    if(res && wctx->sub) {
+        *res = wctx->init;
+
+        for(ssize_t i = 0; i != -1; ) {
+            *res = combine(*res, wctx->partial[i], wctx->ctx);
+
+            i = wctx->sub[i].succ == DLLIST_NULL_
+                ? -1
+                : dllist_rank_find_(wctx->sub, wctx->nsub, wctx->sub[i].succ);
+        }
+    }
+    else if(res) {
+        *res = wctx->init;
+
+        for(ssize_t i = 0; i < nunit; ++i)
+            *res = combine(*res, wctx->partial[i], wctx->ctx);
+    }
+
+    NFREE(wctx->partial);
+    NFREE(wctx->mark);
+    NFREE(wctx->sub);
+
+    return DLLIST_NONE;
+}
+
+static inline int64_t dllist_walk_one_(dllist_walk_ctx_t_* wctx, ssize_t ind, int64_t acc)
+{
+    if(wctx->visit) {
+        wctx->visit(&DLLIST_DATA(wctx->dllist, ind), wctx->ctx);
+        return acc;
+    }
+
+    return wctx->fold(acc, DLLIST_DATA(wctx->dllist, ind), wctx->ctx);
+}
+
+static void dllist_walk_body_(void* arg, int worker, ssize_t lo, ssize_t hi)
+{
+    (void) worker;
+
+    dllist_walk_ctx_t_* wctx   = (dllist_walk_ctx_t_*) arg;
+    dllist_t*           dllist = wctx->dllist;
+
+    for(ssize_t unit = lo; unit < hi; ++unit) {
+        int64_t acc = wctx->init;
+
+        if(wctx->sub) {
+            ssize_t ind = wctx->sub[unit].head;
+
+            do {
+                acc = dllist_walk_one_(wctx, ind, acc);
+                ind = DLLIST_NEXT(dllist, ind);
+            } while(ind != DLLIST_NULL_ && !DLLIST_RANK_MARKED_(wctx->mark, ind));
+
+            wctx->sub[unit].succ = ind;
+        }
+        else {
+            ssize_t first = unit * DLLIST_PARALLEL_CHUNK_;
+            ssize_t last  = first + DLLIST_PARALLEL_CHUNK_ < dllist->hwm ? first + DLLIST_PARALLEL_CHUNK_ : dllist->hwm;
+
+            for(ssize_t ind = first > DLLIST_NULL_ ? first : DLLIST_NULL_ + 1; ind < last; ++ind)
+                if(DLLIST_PREV(dllist, ind) != DLLIST_NONE_)
+                    acc = dllist_walk_one_(wctx, ind, acc);
+        }
+
+        wctx->partial[unit] = acc;
+    }
+}
+
+// Room for n elements in all without growing: the node block, and the 
+// hash table of a list that has one, are sized for them up front
+dllist_err_t dllist_reserve(dllist_t* dllist, ssize_t n)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    utils_assert(n >= 0);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    if(n >= DLLIST_IDX_MAX_)
+        err = DLLIST_CPCTY_OVERFLOW;
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    if(n > dllist->size) {
+        err = dllist_hash_reserve_(dllist, n - dllist->size);
+        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    }
+
+    if(n + 1 > dllist->cpcty) {
+        err = dllist_realloc_(dllist, n + 1);
+        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    }
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// Moves every node into the lowest slots and cuts the capacity down to 
+// the elements it holds
+dllist_err_t dllist_shrink_to_fit(dllist_t* dllist)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    if(dllist->compact || dllist->hwm - 1 > dllist->size) {
+        err = dllist_compact_(dllist, SSIZE_MAX);
+        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    }
+
+    utils_assert(dllist->hwm == dllist->size + 1);
+
+    ssize_t nw_cpcty = 
+        dllist->hwm < DLLIST_CPCTY_THREASHOLD_ 
+        ? DLLIST_CPCTY_THREASHOLD_ 
+        : dllist->hwm;
+
+    if(nw_cpcty < dllist->cpcty) {
+        err = dllist_realloc_(dllist, nw_cpcty);
+        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    }
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// One step of incremental compaction, moving at most budget nodes; the 
+// cycle is over once dllist->compact is NULL again. Moved nodes change 
+// slot, so slot indices held across the call go stale. A cycle gives up 
+// on reaching a slot out through dllist_take_slots, and while any is out 
+// hwm - 1 > size does not mean there is anything left to compact
+dllist_err_t dllist_compact(dllist_t* dllist, ssize_t budget)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    utils_assert(budget > 0);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    if(dllist->compact || dllist->hwm - 1 > dllist->size) {
+        err = dllist_compact_(dllist, budget);
+        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    }
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// From now on every delete may move up to step nodes, as dllist_compact 
+// would, once a quarter of the slots below the high-water mark are holes. 
+// Slot indices then go stale on any delete; 0 turns it off again
+void dllist_auto_compact(dllist_t* dllist, ssize_t step)
+{
+    utils_assert(dllist);
+    utils_assert(step >= 0);
+
+    dllist->compact_step = step;
+}
+
+// Free slots go to the free list, during a compaction cycle to its 
+// bitmap, where they wait to be filled from the top or by inserts, and 
+// with dllist_near_enable to the free-slot bitmap
+static void dllist_free_slot_(dllist_t* dllist, ssize_t slot)
+{
+    DLLIST_PREV(dllist, slot) = DLLIST_IDX_(DLLIST_NONE_);
+
+    if(!dllist->compact && !dllist->freemap) {
+        DLLIST_NEXT(dllist, slot) = DLLIST_IDX_(dllist->free);
+        dllist->free              = slot;
+
+        return;
+    }
+
+    DLLIST_NEXT(dllist, slot) = DLLIST_NULL_;
+
+    if(dllist->compact) {
+        dllist->compact[slot / 64] |= 1ull << (slot % 64);
+
+        if(slot < dllist->compact_lo)
+            dllist->compact_lo = slot;
+    }
+    else {
+        dllist->freemap[slot / 64] |= 1ull << (slot % 64);
+
+        if(slot < dllist->freemap_lo)
+            dllist->freemap_lo = slot;
+    }
+}
+
+// A cycle first takes the free list apart into a bitmap of holes, a 
+// bounded part per step, since the list is in no useful order. Then the 
+// node in the top slot is moved into the lowest hole, over and over, 
+// and free slots at the top are cut off the high-water mark. Once no 
+// hole is left below it the cycle ends and spare capacity is returned
+static dllist_err_t dllist_compact_(dllist_t* dllist, ssize_t budget)
+{
+    if(!dllist->compact) {
+        uint64_t* map = (uint64_t*) calloc((size_t) dllist->cpcty / 64 + 1, sizeof(uint64_t));
+
+        if(!map)
+            return DLLIST_ALLOC_FAIL;
+
+        // free slots already in a bitmap are the cycle's holes as they are
+        if(dllist->freemap) {
+            dllist->compact    = dllist->freemap;
+            dllist->compact_lo = dllist->freemap_lo;
+
+            dllist->freemap    = map;
+            dllist->freemap_lo = dllist->hwm;
+        }
+        else {
+            dllist->compact    = map;
+            dllist->compact_lo = dllist->hwm;
+        }
+    }
+
+    ssize_t detach = budget > SSIZE_MAX / DLLIST_COMPACT_DETACH_ ? SSIZE_MAX : budget * DLLIST_COMPACT_DETACH_;
+
+    for(; detach > 0 && dllist->free != DLLIST_NULL_; --detach) {
+        ssize_t slot = dllist->free;
+        dllist->free = DLLIST_NEXT(dllist, slot);
+
+        dllist_free_slot_(dllist, slot);
+    }
+
+    for(ssize_t moved = 0; ; ++moved) {
+        while(dllist->hwm - 1 > DLLIST_NULL_ && (dllist->compact[(dllist->hwm - 1) / 64] & (1ull << ((dllist->hwm - 1) % 64)))) {
+            --dllist->hwm;
+            dllist->compact[dllist->hwm / 64] &= ~(1ull << (dllist->hwm % 64));
+        }
+
+        ssize_t hole = dllist_compact_hole_(dllist);
+        ssize_t top  = dllist->hwm - 1;
+
+        if(hole == DLLIST_NULL_) {
+            if(dllist->free == DLLIST_NULL_)
+                break;
+
+            return DLLIST_NONE;
+        }
+
+        if(moved == budget)
+            return DLLIST_NONE;
+
+        // A free top slot still on the free list has to be detached 
+        // first. With the free list empty it was taken out by 
+        // dllist_take_slots and cannot be moved, so the cycle gives up
+        if(DLLIST_PREV(dllist, top) == DLLIST_NONE_) {
+            if(dllist->free == DLLIST_NULL_)
+                dllist_compact_abort_(dllist);
+
+            return DLLIST_NONE;
+        }
+
+        dllist->compact[hole / 64] &= ~(1ull << (hole % 64));
+
+        dllist_compact_move_(dllist, top, hole);
+
+        dllist->compact[top / 64] |= 1ull << (top % 64);
+    }
+
+    dllist_compact_end_(dllist);
+
+    // growth doubles, so capacity is given back only past twice the use
+    if(dllist->cpcty > dllist->hwm * 2 && dllist->cpcty > DLLIST_CPCTY_THREASHOLD_) {
+        ssize_t nw_cpcty = dllist->hwm + dllist->hwm / 2;
+
+        return dllist_realloc_(dllist, nw_cpcty < DLLIST_CPCTY_THREASHOLD_ ? DLLIST_CPCTY_THREASHOLD_ : nw_cpcty);
+    }
+
+    return DLLIST_NONE;
+}
+
+// Everything below compact_lo is filled, so the scan resumes there
+static ssize_t dllist_compact_hole_(dllist_t* dllist)
+{
+    return dllist_bitmap_lowest_(dllist->compact, &dllist->compact_lo, dllist->hwm);
+}
+
+static void dllist_compact_move_(dllist_t* dllist, ssize_t from, ssize_t to)
+{
+    ssize_t prv = DLLIST_PREV(dllist, from);
+    ssize_t nxt = DLLIST_NEXT(dllist, from);
+
+    dllist_index_unlink_(dllist, from);
+
+    DLLIST_DATA(dllist, to) = DLLIST_DATA(dllist, from);
+    DLLIST_NEXT(dllist, to) = DLLIST_IDX_(nxt);
+    DLLIST_PREV(dllist, to) = DLLIST_IDX_(prv);
+
+    DLLIST_NEXT(dllist, prv) = DLLIST_IDX_(to);
+    DLLIST_PREV(dllist, nxt) = DLLIST_IDX_(to);
+
+    DLLIST_NEXT(dllist, from) = DLLIST_NULL_;
+    DLLIST_PREV(dllist, from) = DLLIST_IDX_(DLLIST_NONE_);
+
+    dllist->is_linear = 0;
+
+    dllist_index_link_(dllist, to, prv);
+}
+
+static void dllist_compact_end_(dllist_t* dllist)
+{
+    NFREE(dllist->compact);
+
+    dllist->compact_lo = 0;
+}
+
+// Ends a cycle before its holes are filled; they are freed again
+static void dllist_compact_abort_(dllist_t* dllist)
+{
+    uint64_t* map = dllist->compact;
+    ssize_t   lo  = dllist->compact_lo;
+
+    dllist->compact    = NULL;
+    dllist->compact_lo = 0;
+
+    for(ssize_t slot = dllist_bitmap_lowest_(map, &lo, dllist->hwm); slot != DLLIST_NULL_; 
+                slot = dllist_bitmap_lowest_(map, &lo, dllist->hwm)) {
+        map[slot / 64] &= ~(1ull << (slot % 64));
+
+        dllist_free_slot_(dllist, slot);
+    }
+
+    free(map);
+}
+
+// Run after deletes. A cycle is started once a quarter of the slots 
+// below the high-water mark are holes; a failed start is left for the 
+// next delete to retry
+static void dllist_compact_auto_(dllist_t* dllist)
+{
+    if(dllist->compact_step == 0)
+        return;
+
+    if(!dllist->compact && (dllist->hwm - 1 - dllist->size) * 4 <= dllist->hwm - 1)
+        return;
+
+    (void) dllist_compact_(dllist, dllist->compact_step);
+}
+
+// Free slots are kept in a bitmap instead of the free list, so inserts 
+// can pick one next to where they link the node in
+dllist_err_t dllist_near_enable(dllist_t* dllist)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    if(dllist->freemap)
+        return DLLIST_NONE;
+
+    dllist_err_t err = DLLIST_NONE;
+
+    dllist->freemap = (uint64_t*) calloc((size_t) dllist->cpcty / 64 + 1, sizeof(uint64_t));
+
+    if(!dllist->freemap)
+        err = DLLIST_ALLOC_FAIL;
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    dllist->freemap_lo = dllist->hwm;
+
+    // a running compaction cycle takes the free list apart by itself
+    while(!dllist->compact && dllist->free != DLLIST_NULL_) {
+        ssize_t slot = dllist->free;
+        dllist->free = DLLIST_NEXT(dllist, slot);
+
+        dllist_free_slot_(dllist, slot);
+    }
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+void dllist_near_disable(dllist_t* dllist)
+{
+    utils_assert(dllist);
+
+    if(!dllist->freemap)
+        return;
+
+    uint64_t* map = dllist->freemap;
+    ssize_t   lo  = dllist->freemap_lo;
+
+    dllist->freemap    = NULL;
+    dllist->freemap_lo = 0;
+
+    for(ssize_t slot = dllist_bitmap_lowest_(map, &lo, dllist->hwm); slot != DLLIST_NULL_; 
+                slot = dllist_bitmap_lowest_(map, &lo, dllist->hwm)) {
+        map[slot / 64] &= ~(1ull << (slot % 64));
+
+        dllist_free_slot_(dllist, slot);
+    }
+
+    free(map);
+}
+
+// All slots below the high-water mark are in use again
+static void dllist_freemap_clear_(dllist_t* dllist)
+{
+    if(!dllist->freemap)
+        return;
+
+    memset(dllist->freemap, 0, ((size_t) dllist->cpcty / 64 + 1) * sizeof(uint64_t));
+
+    dllist->freemap_lo = DLLIST_NULL_;
+}
+
+static dllist_err_t dllist_bitmap_fit_(uint64_t** map, ssize_t cpcty, ssize_t nw_cpcty)
+{
+    if(!*map || nw_cpcty <= cpcty)
+        return DLLIST_NONE;
+
+    size_t words    = (size_t) cpcty / 64 + 1;
+    size_t nw_words = (size_t) nw_cpcty / 64 + 1;
+
+    void* tmp = realloc(*map, nw_words * sizeof(uint64_t));
+
+    if(!tmp)
+        return DLLIST_ALLOC_FAIL;
+
+    *map = (uint64_t*) tmp;
+
+    memset(*map + words, 0, (nw_words - words) * sizeof(uint64_t));
+
+    return DLLIST_NONE;
+}
+
+// Lowest set bit below hwm, DLLIST_NULL_ if none. No bit is set below 
+// *lo, which is moved up to the one found
+static ssize_t dllist_bitmap_lowest_(const uint64_t* map, ssize_t* lo, ssize_t hwm)
+{
+    ssize_t ind = *lo;
+
+    while(ind < hwm) {
+        uint64_t word = map[ind / 64] >> (ind % 64);
+
+        if(word) {
+            ind += __builtin_ctzll(word);
+            break;
+        }
+
+        ind = (ind / 64 + 1) * 64;
+    }
+
+    if(ind > hwm)
+        ind = hwm;
+
+    *lo = ind;
+
+    return ind < hwm ? ind : DLLIST_NULL_;
+}
+
+// Set bit closest to `after` within DLLIST_NEAR_WORDS_ words either side, 
+// the ones above it first, DLLIST_NULL_ if none
+static ssize_t dllist_bitmap_near_(const uint64_t* map, ssize_t after, ssize_t hwm)
+{
+    ssize_t  words = (hwm + 63) / 64;
+    ssize_t  base  = after / 64;
+    uint64_t word  = map[base];
+    int      bit   = (int) (after % 64);
+
+    uint64_t above = bit == 63 ? 0 : word & (~0ull << (bit + 1));
+    uint64_t below = word & ((1ull << bit) - 1);
+
+    if(above)
+        return base * 64 + __builtin_ctzll(above);
+
+    if(below)
+        return base * 64 + 63 - __builtin_clzll(below);
+
+    for(ssize_t dist = 1; dist <= DLLIST_NEAR_WORDS_; ++dist) {
+        if(base + dist < words && map[base + dist])
+            return (base + dist) * 64 + __builtin_ctzll(map[base + dist]);
+
+        if(base - dist >= 0 && map[base - dist])
+            return (base - dist) * 64 + 63 - __builtin_clzll(map[base - dist]);
+    }
+
+    return DLLIST_NULL_;
+}
+
+// Writes the slots below the high-water mark as they lie in memory. 
+// The file only knows the free list, so free slots kept in a bitmap are 
+// chained in front of it for the write; slots held detached from 
+// dllist_take_slots are neither free nor linked in the file
+dllist_err_t dllist_save(dllist_t* dllist, const char* path)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    utils_assert(path);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    ssize_t free_head = dllist->free;
+
+    free_head = dllist_bitmap_chain_(dllist, dllist->compact, free_head);
+    free_head = dllist_bitmap_chain_(dllist, dllist->freemap, free_head);
+
+    dllist_file_hdr_t_ hdr = {};
+
+    dllist_file_hdr_(dllist, &hdr, dllist->hwm, free_head);
+
+    size_t hwm = (size_t) dllist->hwm;
+
+    FILE* file = fopen(path, "wb");
+    int   ok   = file && fwrite(&hdr, sizeof(hdr), 1, file) == 1;
+
+#ifdef DLLIST_AOS
+    ok = ok && fwrite(dllist->node, sizeof(dllist_node_t), hwm, file) == hwm;
+#else // DLLIST_AOS
+    ok = ok && fwrite(dllist->next, sizeof(dllist_idx_t),  hwm, file) == hwm;
+    ok = ok && fwrite(dllist->prev, sizeof(dllist_idx_t),  hwm, file) == hwm;
+    ok = ok && fwrite(dllist->data, sizeof(dllist_data_t), hwm, file) == hwm;
+#endif // DLLIST_AOS
+
+    if(file)
+        ok = fclose(file) == 0 && ok;
+
+    dllist_bitmap_unchain_(dllist, free_head);
+
+    if(!ok)
+        err = DLLIST_FILE_FAIL;
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// Maps the snapshot copy-on-write in place of the node block, without 
+// reading it: pages come in as they are touched and the ones written to 
+// stay private. The first realloc copies the nodes out to the heap
+dllist_err_t dllist_load_mmap(dllist_t* dllist, const char* path, char* log_filename)
+{
+    utils_assert(dllist);
+    utils_assert(path);
+
+    (void) log_filename;
+
+    IF_DEBUG(
+        utils_assert(log_filename);
+        utils_init_log_file(log_filename, LOG_DIR);
+    )
+
+    dllist_err_t err = DLLIST_NONE;
+
+    dllist_init_(dllist);
+
+    dllist_file_hdr_t_ hdr = {};
+    struct stat        st  = {};
+
+    int fd = open(path, O_RDONLY);
+
+    if(fd < 0)
+        return DLLIST_FILE_FAIL;
+
+    if(fstat(fd, &st) != 0 || pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t) sizeof(hdr))
+        err = DLLIST_FILE_FAIL;
+    else
+        err = dllist_file_check_(&hdr, st.st_size);
+
+    void* map = MAP_FAILED;
+
+    if(err == DLLIST_NONE) {
+        map = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+        if(map == MAP_FAILED)
+            err = DLLIST_FILE_FAIL;
+    }
+
+    close(fd);
+
+    if(err != DLLIST_NONE)
+        return err;
+
+    dllist_carve_(dllist, (char*) map + sizeof(hdr), hdr.cpcty);
+
+    dllist->mapped    = (size_t) st.st_size;
+    dllist->cpcty     = hdr.cpcty;
+    dllist->hwm       = hdr.hwm;
+    dllist->size      = hdr.size;
+    dllist->free      = hdr.free;
+    dllist->is_linear = hdr.is_linear;
+
+    dllist_map_advise_(dllist);
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// The node block lives in a shared mapping of the file, in the snapshot 
+// format, and grows with the file, so the page cache rather than swap 
+// holds what is not in use. A file holding a list is opened as it is, 
+// an empty or new one gets init_cpcty slots. The header in the file is 
+// brought up to date by dllist_sync and dllist_dtor
+dllist_err_t dllist_ctor_file(dllist_t* dllist, const char* path, ssize_t init_cpcty, char* log_filename)
+{
+    utils_assert(dllist);
+    utils_assert(path);
+    utils_assert(init_cpcty > 0);
+
+    (void) log_filename;
+
+    IF_DEBUG(
+        utils_assert(log_filename);
+        utils_init_log_file(log_filename, LOG_DIR);
+    )
+
+    dllist_err_t err = DLLIST_NONE;
+
+    dllist_init_(dllist);
+
+    dllist_file_hdr_t_ hdr = {};
+    struct stat        st  = {};
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+
+    if(fd < 0)
+        return DLLIST_FILE_FAIL;
+
+    int fresh = 0;
+
+    if(fstat(fd, &st) != 0)
+        err = DLLIST_FILE_FAIL;
+
+    else if(st.st_size == 0) {
+        fresh     = 1;
+        hdr.cpcty = init_cpcty < DLLIST_CPCTY_THREASHOLD_ ? DLLIST_CPCTY_THREASHOLD_ : init_cpcty;
+
+        if(hdr.cpcty > DLLIST_IDX_MAX_)
+            err = DLLIST_CPCTY_OVERFLOW;
+
+        else {
+            st.st_size = (off_t) (sizeof(hdr) + (size_t) hdr.cpcty * DLLIST_NODE_SIZE_);
+
+            if(ftruncate(fd, st.st_size) != 0)
+                err = DLLIST_FILE_FAIL;
+        }
+    }
+
+    else if(pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t) sizeof(hdr))
+        err = DLLIST_FILE_FAIL;
+
+    else
+        err = dllist_file_check_(&hdr, st.st_size);
+
+    void* map = MAP_FAILED;
+
+    if(err == DLLIST_NONE) {
+        map = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if(map == MAP_FAILED)
+            err = DLLIST_FILE_FAIL;
+    }
+
+    if(err != DLLIST_NONE) {
+        close(fd);
+        return err;
+    }
+
+    dllist_carve_(dllist, (char*) map + sizeof(hdr), hdr.cpcty);
+
+    dllist->fd     = fd;
+    dllist->mapped = (size_t) st.st_size;
+    dllist->cpcty  = hdr.cpcty;
+
+    if(fresh)
+        dllist_clear_(dllist);
+
+    else {
+        dllist->hwm       = hdr.hwm;
+        dllist->size      = hdr.size;
+        dllist->free      = hdr.free;
+        dllist->is_linear = hdr.is_linear;
+    }
+
+    dllist_file_hdr_(dllist, (dllist_file_hdr_t_*) map, dllist->cpcty, dllist->free);
+
+    dllist_map_advise_(dllist);
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// Writes the header of a file-backed list and flushes the mapping, 
+// waiting for the disk if wait is set. Free slots in a bitmap are 
+// chained into the file's free list only while the header is current; 
+// once they are unchained again a crash can leak but not corrupt them
+dllist_err_t dllist_sync(dllist_t* dllist, int wait)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    if(dllist->fd < 0)
+        return DLLIST_NONE;
+
+    dllist_err_t err = DLLIST_NONE;
+
+    char* base = (char*) dllist_block_(dllist) - sizeof(dllist_file_hdr_t_);
+
+    ssize_t free_head = dllist->free;
+
+    free_head = dllist_bitmap_chain_(dllist, dllist->compact, free_head);
+    free_head = dllist_bitmap_chain_(dllist, dllist->freemap, free_head);
+
+    dllist_file_hdr_(dllist, (dllist_file_hdr_t_*) base, dllist->cpcty, free_head);
+
+    if(msync(base, dllist->mapped, wait ? MS_SYNC : MS_ASYNC) != 0)
+        err = DLLIST_FILE_FAIL;
+
+    dllist_bitmap_unchain_(dllist, free_head);
+
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// Moves a loaded snapshot's nodes out of the mapping into a heap block
+static dllist_err_t dllist_unmap_(dllist_t* dllist, ssize_t nw_cpcty)
+{
+    void* block = NULL;
+
+    dllist_err_t err = dllist_block_resize_(dllist, &block, 0, nw_cpcty);
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    size_t hwm = (size_t) dllist->hwm;
+
+#ifdef DLLIST_AOS
+    memcpy(block, dllist->node, hwm * sizeof(dllist_node_t));
+#else // DLLIST_AOS
+    char* base = (char*) block;
+
+    memcpy(base,                                                  dllist->next, hwm * sizeof(dllist_idx_t));
+    memcpy(base + (size_t) nw_cpcty * sizeof(dllist_idx_t),     dllist->prev, hwm * sizeof(dllist_idx_t));
+    memcpy(base + (size_t) nw_cpcty * sizeof(dllist_idx_t) * 2, dllist->data, hwm * sizeof(dllist_data_t));
+#endif // DLLIST_AOS
+
+    munmap((char*) dllist_block_(dllist) - sizeof(dllist_file_hdr_t_), dllist->mapped);
+
+    dllist->mapped = 0;
+
+    dllist_carve_(dllist, block, nw_cpcty);
+
+    dllist->cpcty = nw_cpcty;
+
+    return DLLIST_NONE;
+}
+
+static dllist_err_t dllist_file_check_(const dllist_file_hdr_t_* hdr, off_t file_size)
+{
+    if(memcmp(hdr->magic, DLLIST_FILE_MAGIC_, sizeof(hdr->magic)) != 0)
+        return DLLIST_BAD_FILE;
+
+    if(hdr->version != DLLIST_FILE_VERSION_ || hdr->endian != DLLIST_FILE_ENDIAN_)
+        return DLLIST_BAD_FILE;
+
+#ifdef DLLIST_AOS
+    if(hdr->aos != 1)
+        return DLLIST_BAD_FILE;
+#else // DLLIST_AOS
+    if(hdr->aos != 0)
+        return DLLIST_BAD_FILE;
+#endif // DLLIST_AOS
+
+    if(hdr->idx_size != sizeof(dllist_idx_t) || hdr->data_size != sizeof(dllist_data_t))
+        return DLLIST_BAD_FILE;
+
+    if(hdr->cpcty > DLLIST_IDX_MAX_ || hdr->hwm > hdr->cpcty || hdr->size < 0 || hdr->size >= hdr->hwm)
+        return DLLIST_BAD_FILE;
+
+    if(hdr->free < DLLIST_NULL_ || hdr->free >= hdr->hwm)
+        return DLLIST_BAD_FILE;
+
+    if((uint64_t) file_size < sizeof(*hdr) + (uint64_t) hdr->cpcty * DLLIST_NODE_SIZE_)
+        return DLLIST_BAD_FILE;
+
+    return DLLIST_NONE;
+}
+
+static void dllist_file_hdr_(dllist_t* dllist, dllist_file_hdr_t_* hdr, ssize_t cpcty, ssize_t free_head)
+{
+    memcpy(hdr->magic, DLLIST_FILE_MAGIC_, sizeof(hdr->magic));
+
+    hdr->version   = DLLIST_FILE_VERSION_;
+    hdr->endian    = DLLIST_FILE_ENDIAN_;
+#ifdef DLLIST_AOS
+    hdr->aos       = 1;
+#else // DLLIST_AOS
+    hdr->aos       = 0;
+#endif // DLLIST_AOS
+    hdr->idx_size  = sizeof(dllist_idx_t);
+    hdr->data_size = sizeof(dllist_data_t);
+    hdr->is_linear = (uint16_t) dllist->is_linear;
+    hdr->cpcty     = cpcty;
+    hdr->hwm       = dllist->hwm;
+    hdr->size      = dllist->size;
+    hdr->free      = free_head;
+}
+
+// The file grows before its mapping does and shrinks after it; a file 
+// that fails to shrink is only longer than it needs to be
+static dllist_err_t dllist_file_resize_(dllist_t* dllist, void** block, ssize_t nw_cpcty)
+{
+    size_t len  = sizeof(dllist_file_hdr_t_) + (size_t) nw_cpcty * DLLIST_NODE_SIZE_;
+    char*  base = (char*) *block - sizeof(dllist_file_hdr_t_);
+
+    if(len > dllist->mapped && ftruncate(dllist->fd, (off_t) len) != 0)
+        return DLLIST_FILE_FAIL;
+
+    void* map = mremap(base, dllist->mapped, len, MREMAP_MAYMOVE);
+
+    if(map == MAP_FAILED)
+        return DLLIST_FILE_FAIL;
+
+    if(len < dllist->mapped)
+        (void) !ftruncate(dllist->fd, (off_t) len);
+
+    dllist->mapped = len;
+
+    ((dllist_file_hdr_t_*) map)->cpcty = nw_cpcty;
+
+    *block = (char*) map + sizeof(dllist_file_hdr_t_);
+
+    return DLLIST_NONE;
+}
+
+// Traversal of a linear list walks the mapping front to back, anything 
+// else jumps around it, so readahead only pays off for the former
+static void dllist_map_advise_(dllist_t* dllist)
+{
+    if(!dllist->mapped)
+        return;
+
+    char* base = (char*) dllist_block_(dllist) - sizeof(dllist_file_hdr_t_);
+
+    (void) madvise(base, dllist->mapped, dllist->is_linear ? MADV_SEQUENTIAL : MADV_RANDOM);
+}
+
+// next of a slot in a bitmap is unused, so the slots can be chained 
+// through it in front of head without leaving the bitmap
+static ssize_t dllist_bitmap_chain_(dllist_t* dllist, const uint64_t* map, ssize_t head)
+{
+    if(!map)
+        return head;
+
+    for(ssize_t w = (dllist->hwm - 1) / 64; w >= 0; --w) {
+        for(uint64_t word = map[w]; word; word &= word - 1) {
+            ssize_t slot = w * 64 + __builtin_ctzll(word);
+
+            DLLIST_NEXT(dllist, slot) = DLLIST_IDX_(head);
+            head                      = slot;
+        }
+    }
+
+    return head;
+}
+
+// Puts the links chained by dllist_bitmap_chain_ back to unused
+static void dllist_bitmap_unchain_(dllist_t* dllist, ssize_t head)
+{
+    for(ssize_t slot = head, nxt = DLLIST_NULL_; slot != dllist->free; slot = nxt) {
+        nxt = DLLIST_NEXT(dllist, slot);
+        DLLIST_NEXT(dllist, slot) = DLLIST_NULL_;
+    }
+}
+
+// Slots are handed out detached: off the free list and not linked, 
+// still marked free by prev until the caller links them in itself. 
+// Compaction cannot move them and stops short of them
+dllist_err_t dllist_take_slots(dllist_t* dllist, ssize_t* slots, ssize_t n)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    utils_assert(slots || n == 0);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    for(ssize_t i = 0; i < n; ++i) {
+        err = dllist_take_slot_(dllist, &slots[i]);
+
+        if(err != DLLIST_NONE) {
+            dllist_release_slots(dllist, slots, i);
+            return err;
+        }
+
+        DLLIST_NEXT(dllist, slots[i]) = DLLIST_NULL_;
+        DLLIST_PREV(dllist, slots[i]) = DLLIST_IDX_(DLLIST_NONE_);
+    }
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+// Gives detached slots back to the free list
+void dllist_release_slots(dllist_t* dllist, const ssize_t* slots, ssize_t n)
+{
+    utils_assert(dllist);
+    utils_assert(slots || n == 0);
+
+    for(ssize_t i = 0; i < n; ++i)
+        dllist_free_slot_(dllist, slots[i]);
+
+    DLLIST_DUMP_(dllist, DLLIST_NONE);
+}
+
+ssize_t dllist_next(dllist_t* dllist, ssize_t after)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    IF_DEBUG(
+        dllist_err_t err = DLLIST_NONE; 
+
+        if(after < 0)
+            err = DLLIST_OUT_OF_BOUND;
+        else if(after >= dllist->hwm)
+            err = DLLIST_OUT_OF_BOUND;
+
+        if(err != DLLIST_NULL_) {
+            DLLIST_DUMP_(dllist, err);
+            return err;
+        }
+    );
+
+    return DLLIST_NEXT(dllist, after);
+}
+
+ssize_t dllist_prev(dllist_t* dllist, ssize_t before)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    IF_DEBUG(
+        dllist_err_t err = DLLIST_NONE; 
+
+        if(before <= 0)
+            err = DLLIST_OUT_OF_BOUND;
+        else if(before >= dllist->hwm)
+            err = DLLIST_OUT_OF_BOUND;
+
+        if(err != DLLIST_NULL_) {
+            DLLIST_DUMP_(dllist, err);
+            return err;
+        }
+    );
+
+    return DLLIST_PREV(dllist, before);
+}
+
+ssize_t dllist_begin(dllist_t* dllist)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    return DLLIST_NEXT(dllist, DLLIST_NULL_);
+}
+
+ssize_t dllist_end(dllist_t* dllist)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    return DLLIST_PREV(dllist, DLLIST_NULL_);
+}
+
+
+// Nodes from first to last move out of src into one run of fresh slots 
+// of dst, which is linked and spliced in like a bulk insert; within one 
+// list the run is just relinked
+dllist_err_t dllist_splice(dllist_t* dst, ssize_t after, dllist_t* src, ssize_t first, ssize_t last)
+{
+    DLLIST_ASSERT_OK_(dst);
+    DLLIST_ASSERT_OK_(src);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    IF_DEBUG(
+        if(after >= dst->hwm || after < DLLIST_NULL_)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else if(first >= src->hwm || last >= src->hwm)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else if(first <= DLLIST_NULL_ || last <= DLLIST_NULL_)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else {
+            ssize_t ind = first;
+
+            while(ind != last && ind != DLLIST_NULL_ && (dst != src || ind != after))
+                ind = DLLIST_NEXT(src, ind);
+
+            if(ind != last || (dst == src && after == last))
+                err = DLLIST_OUT_OF_BOUND;
+        }
+
+        if(err != DLLIST_NONE) {
+            DLLIST_DUMP_(dst, err);
+            return err;
+        }
+    )
+
+    if(dst == src) {
+        ssize_t before = DLLIST_PREV(src, first);
+        ssize_t behind = DLLIST_NEXT(src, last);
+
+        for(ssize_t ind = first; ; ind = DLLIST_NEXT(src, ind)) {
+            dllist_order_remove_(src, ind);
+
+            if(ind == last)
+                break;
+        }
+
+        DLLIST_NEXT(src, before) = DLLIST_IDX_(behind);
+        DLLIST_PREV(src, behind) = DLLIST_IDX_(before);
+
+        DLLIST_NEXT(src, last)                    = DLLIST_NEXT(src, after);
+        DLLIST_PREV(src, first)                   = DLLIST_IDX_(after);
+        DLLIST_PREV(src, DLLIST_NEXT(src, after)) = DLLIST_IDX_(last);
+        DLLIST_NEXT(src, after)                   = DLLIST_IDX_(first);
+
+        for(ssize_t ind = first, prv = after; ; prv = ind, ind = DLLIST_NEXT(src, ind)) {
+            dllist_order_insert_(src, ind, prv);
+
+            if(ind == last)
+                break;
+        }
+
+        src->is_linear = 0;
+
+        DLLIST_DUMP_(src, err);
+
+        return DLLIST_NONE;
+    }
+
+    ssize_t cnt = 1;
+
+    for(ssize_t ind = first; ind != last; ind = DLLIST_NEXT(src, ind))
+        ++cnt;
+
+    err = dllist_reserve_run_(dst, cnt);
+    DLLIST_VERIFY_OR_RETURN_(dst, err);
+
+    ssize_t ind = first;
+
+    for(ssize_t i = 0; i < cnt; ++i) {
+        DLLIST_DATA(dst, dst->hwm + i) = DLLIST_DATA(src, ind);
+        ind = DLLIST_NEXT(src, ind);
+    }
+
+    dllist_link_run_(dst, cnt, after);
+
+    DLLIST_DUMP_(dst, err);
+
+    return dllist_erase_range(src, first, last);
+}
+
+// Both lists must be sorted ascending; src values go into one run of 
+// fresh slots of dst, each linked in after the last dst node not 
+// greater than it, and src is left empty
+dllist_err_t dllist_merge(dllist_t* dst, dllist_t* src)
+{
+    DLLIST_ASSERT_OK_(dst);
+    DLLIST_ASSERT_OK_(src);
+
+    utils_assert(dst != src);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    if(src->size == 0)
+        return DLLIST_NONE;
+
+    err = dllist_reserve_run_(dst, src->size);
+    DLLIST_VERIFY_OR_RETURN_(dst, err);
+
+    ssize_t pos = DLLIST_NULL_;
+    ssize_t ind = DLLIST_NEXT(src, DLLIST_NULL_);
+
+    while(ind != DLLIST_NULL_) {
+        dllist_data_t val = DLLIST_DATA(src, ind);
+
+        while(DLLIST_NEXT(dst, pos) != DLLIST_NULL_ 
+              && DLLIST_DATA(dst, DLLIST_NEXT(dst, pos)) <= val)
+            pos = DLLIST_NEXT(dst, pos);
+
+        ssize_t cur = dst->hwm++;
+
+        DLLIST_DATA(dst, cur) = val;
+
+        dst->is_linear = 
+            dst->is_linear 
+            && pos == DLLIST_PREV(dst, DLLIST_NULL_) 
+            && cur == dst->size + 1;
+
+        DLLIST_NEXT(dst, cur)                   = DLLIST_NEXT(dst, pos);
+        DLLIST_PREV(dst, cur)                   = DLLIST_IDX_(pos);
+        DLLIST_PREV(dst, DLLIST_NEXT(dst, pos)) = DLLIST_IDX_(cur);
+        DLLIST_NEXT(dst, pos)                   = DLLIST_IDX_(cur);
+
+        ++dst->size;
+
+        dllist_index_link_(dst, cur, pos);
+
+        pos = cur;
+        ind = DLLIST_NEXT(src, ind);
+    }
+
+    dllist_clear_(src);
+
+    DLLIST_DUMP_(dst, err);
+    DLLIST_DUMP_(src, err);
+
+    return DLLIST_NONE;
+}
+
+// Scans the storage rather than the links, so the slot found is not 
+// necessarily the first in list order; free slots are skipped by prev
+ssize_t dllist_find(dllist_t* dllist, dllist_data_t val)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    ssize_t i = DLLIST_NULL_ + 1;
+
+#ifdef DLLIST_SIMD_WIDTH_
+    dllist_simd_t_ key = DLLIST_SIMD_SET_(val);
+
+    for(; i + DLLIST_SIMD_WIDTH_ <= dllist->hwm; i += DLLIST_SIMD_WIDTH_) {
+        unsigned mask = DLLIST_SIMD_MATCH_(&DLLIST_DATA(dllist, i), key);
+
+        for(; mask; mask &= mask - 1) {
+            ssize_t ind = i + __builtin_ctz(mask);
+
+            if(DLLIST_PREV(dllist, ind) != DLLIST_NONE_)
+                return ind;
+        }
+    }
+#endif // DLLIST_SIMD_WIDTH_
+
+    for(; i < dllist->hwm; ++i)
+        if(DLLIST_DATA(dllist, i) == val && DLLIST_PREV(dllist, i) != DLLIST_NONE_)
+            return i;
+
+    return DLLIST_NULL_;
+}
+
+ssize_t dllist_count(dllist_t* dllist, dllist_data_t val)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    ssize_t i   = DLLIST_NULL_ + 1;
+    ssize_t cnt = 0;
+
+#ifdef DLLIST_SIMD_WIDTH_
+    dllist_simd_t_ key = DLLIST_SIMD_SET_(val);
+
+    for(; i + DLLIST_SIMD_WIDTH_ <= dllist->hwm; i += DLLIST_SIMD_WIDTH_) {
+        unsigned mask = DLLIST_SIMD_MATCH_(&DLLIST_DATA(dllist, i), key);
+
+        for(; mask; mask &= mask - 1)
+            cnt += DLLIST_PREV(dllist, i + __builtin_ctz(mask)) != DLLIST_NONE_;
+    }
+#endif // DLLIST_SIMD_WIDTH_
+
+    for(; i < dllist->hwm; ++i)
+        cnt += DLLIST_DATA(dllist, i) == val && DLLIST_PREV(dllist, i) != DLLIST_NONE_;
+
+    return cnt;
+}
+
+ssize_t dllist_find_first(dllist_t* dllist, dllist_data_t val)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    ssize_t ind = DLLIST_NEXT(dllist, DLLIST_NULL_);
+
+    while(ind != DLLIST_NULL_ && DLLIST_DATA(dllist, ind) != val)
+        ind = DLLIST_NEXT(dllist, ind);
+
+    return ind;
+}
+
+dllist_err_t dllist_hash_enable(dllist_t* dllist)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    if(dllist->hash)
+        return DLLIST_NONE;
+
+    dllist_err_t err = DLLIST_NONE;
+
+    dllist->hash = (dllist_hash_t*) calloc(1, sizeof(dllist_hash_t));
+
+    if(!dllist->hash)
+        err = DLLIST_ALLOC_FAIL;
+    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+
+    int bits = DLLIST_HASH_MIN_BITS_;
+
+    while(((ssize_t) 1 << bits) < dllist->size * 2)
+        ++bits;
+
+    err = dllist_hash_rehash_(dllist->hash, bits);
+
+    if(err == DLLIST_NONE)
+        err = dllist_hash_fit_(dllist, dllist->cpcty);
+
+    if(err != DLLIST_NONE) {
+        dllist_hash_disable(dllist);
+        DLLIST_DUMP_(dllist, err);
+        return err;
+    }
+
+    dllist_hash_rebuild_(dllist);
+
+    DLLIST_DUMP_(dllist, err);
+
+    return DLLIST_NONE;
+}
+
+void dllist_hash_disable(dllist_t* dllist)
+{
+    utils_assert(dllist);
+
+    if(!dllist->hash)
+        return;
+
+    NFREE(dllist->hash->keys);
+    NFREE(dllist->hash->heads);
+    NFREE(dllist->hash->hnext);
+    NFREE(dllist->hash->hprev);
+    NFREE(dllist->hash);
+}
+
+// Returns a slot holding val like dllist_find does, in constant time 
+// once the index is enabled
+ssize_t dllist_lookup(dllist_t* dllist, dllist_data_t val)
+{
+    DLLIST_ASSERT_OK_(dllist);
+
+    if(!dllist->hash)
+        return dllist_find(dllist, val);
+
+    return dllist->hash->heads[dllist_hash_probe_(dllist->hash, val)];
+}
+
+// Fibonacci hashing, the top bits of the product pick the bucket
+static size_t dllist_hash_home_(const dllist_hash_t* hash, dllist_data_t val)
+{
+    return (size_t) (((uint64_t)(uint32_t) val * 0x9E3779B97F4A7C15ull) >> (64 - hash->bits));
+}
+
+// Bucket of val, or the empty bucket it would go to
+static size_t dllist_hash_probe_(const dllist_hash_t* hash, dllist_data_t val)
+{
+    size_t mask = ((size_t) 1 << hash->bits) - 1;
+    size_t i    = dllist_hash_home_(hash, val);
+
+    while(hash->heads[i] != DLLIST_NULL_ && hash->keys[i] != val)
+        i = (i + 1) & mask;
+
+    return i;
+}
+
+static dllist_err_t dllist_hash_rehash_(dllist_hash_t* hash, int bits)
+{
+    size_t old_size = hash->keys ? (size_t) 1 << hash->bits : 0;
+    size_t nw_size  = (size_t) 1 << bits;
+
+    dllist_data_t* old_keys  = hash->keys;
+    dllist_idx_t*  old_heads = hash->heads;
+
+    dllist_data_t* keys  = (dllist_data_t*) calloc(nw_size, sizeof(dllist_data_t));
+    dllist_idx_t*  heads = (dllist_idx_t*)  calloc(nw_size, sizeof(dllist_idx_t));
+
+    if(!keys || !heads) {
+        NFREE(keys);
+        NFREE(heads);
+        return DLLIST_ALLOC_FAIL;
+    }
+
+    hash->keys  = keys;
+    hash->heads = heads;
+    hash->bits  = bits;
+
+    for(size_t i = 0; i < old_size; ++i) {
+        if(old_heads[i] == DLLIST_NULL_)
+            continue;
+
+        size_t b = dllist_hash_probe_(hash, old_keys[i]);
+
+        keys[b]  = old_keys[i];
+        heads[b] = old_heads[i];
+    }
+
+    NFREE(old_keys);
+    NFREE(old_heads);
+
+    return DLLIST_NONE;
+}
+
+// Makes room for n more distinct values before any slot is taken, so 
+// that adding to the index later cannot fail
+static dllist_err_t dllist_hash_reserve_(dllist_t* dllist, ssize_t n)
+{
+    dllist_hash_t* hash = dllist->hash;
+
+    if(!hash)
+        return DLLIST_NONE;
+
+    int bits = hash->bits;
+
+    while(((ssize_t) 1 << bits) < (hash->used + n) * 2)
+        ++bits;
+
+    if(bits == hash->bits)
+        return DLLIST_NONE;
+
+    return dllist_hash_rehash_(hash, bits);
+}
+
+// Chains are indexed by slot, they grow ahead of the storage
+static dllist_err_t dllist_hash_fit_(dllist_t* dllist, ssize_t cpcty)
+{
+    dllist_hash_t* hash = dllist->hash;
+
+    if(!hash || hash->cpcty == cpcty)
+        return DLLIST_NONE;
+
+    dllist_err_t err = DLLIST_NONE;
+
+    err = dllist_realloc_idx_(&hash->hnext, cpcty);
+    if(err != DLLIST_NONE)
+        return err;
+
+    err = dllist_realloc_idx_(&hash->hprev, cpcty);
+    if(err != DLLIST_NONE)
+        return err;
+
+    hash->cpcty = cpcty;
+
+    return DLLIST_NONE;
+}
+
+// The slot becomes the head of its value's chain
+static void dllist_hash_add_(dllist_t* dllist, ssize_t slot)
+{
+    dllist_hash_t* hash = dllist->hash;
+
+    if(!hash)
+        return;
+
+    size_t  b    = dllist_hash_probe_(hash, DLLIST_DATA(dllist, slot));
+    ssize_t head = hash->heads[b];
+
+    hash->hnext[slot] = DLLIST_IDX_(head);
+    hash->hprev[slot] = DLLIST_IDX_(DLLIST_NULL_);
+
+    if(head == DLLIST_NULL_) {
+        hash->keys[b] = DLLIST_DATA(dllist, slot);
+        ++hash->used;
+    }
+    else
+        hash->hprev[head] = DLLIST_IDX_(slot);
+
+    hash->heads[b] = DLLIST_IDX_(slot);
+}
+
+static void dllist_hash_remove_(dllist_t* dllist, ssize_t slot)
+{
+    dllist_hash_t* hash = dllist->hash;
+
+    if(!hash)
+        return;
+
+    ssize_t nxt = hash->hnext[slot];
+    ssize_t prv = hash->hprev[slot];
+
+    if(nxt != DLLIST_NULL_)
+        hash->hprev[nxt] = DLLIST_IDX_(prv);
+
+    if(prv != DLLIST_NULL_) {
+        hash->hnext[prv] = DLLIST_IDX_(nxt);
+        return;
+    }
 
-static const ssize_t DLLIST_NONE_ = -1;
+    size_t hole = dllist_hash_probe_(hash, DLLIST_DATA(dllist, slot));
 
-static const ssize_t DLLIST_CPCTY_THREASHOLD_ = 5;
+    if(nxt != DLLIST_NULL_) {
+        hash->heads[hole] = DLLIST_IDX_(nxt);
+        return;
+    }
 
-static dllist_err_t dllist_realloc_arr_(void** ptr, ssize_t nmemb, size_t tsize);
+    // the value is gone; later buckets of the cluster that may probe 
+    // past the hole are shifted back into it, so no tombstones are needed
+    size_t mask = ((size_t) 1 << hash->bits) - 1;
 
-static dllist_err_t dllist_realloc_(dllist_t* dllist, ssize_t nw_cpcty);
+    for(size_t i = (hole + 1) & mask; hash->heads[i] != DLLIST_NULL_; i = (i + 1) & mask) {
+        size_t home = dllist_hash_home_(hash, hash->keys[i]);
 
+        if(((i - home) & mask) < ((i - hole) & mask))
+            continue;
 
-#ifdef _DEBUG
+        hash->keys[hole]  = hash->keys[i];
+        hash->heads[hole] = hash->heads[i];
+        hole = i;
+    }
 
-static dllist_err_t dllist_verify_(dllist_t* dllist);
+    hash->heads[hole] = DLLIST_IDX_(DLLIST_NULL_);
+    --hash->used;
+}
 
-char* dllist_dump_graphviz_(dllist_t* dllist);
+// Walks the list back to front, so every chain starts at the first 
+// slot of its value in list order. Callers size the table beforehand; 
+// should it still fill up to half and fail to grow, the index is dropped 
+// rather than probed forever, and lookups fall back to dllist_find
+static void dllist_hash_rebuild_(dllist_t* dllist)
+{
+    dllist_hash_t* hash = dllist->hash;
 
-void dllist_dump_(dllist_t* dllist, dllist_err_t err, char* msg, const char* filename, int line, const char* funcname);
+    if(!hash)
+        return;
 
-static const char* dllist_strerr_(dllist_err_t err);
+    memset(hash->heads, 0, sizeof(hash->heads[0]) << hash->bits);
+    hash->used = 0;
 
-#endif // _DEBUG
+    for(ssize_t ind = DLLIST_PREV(dllist, DLLIST_NULL_); ind != DLLIST_NULL_; ind = DLLIST_PREV(dllist, ind)) {
+        if(hash->used * 2 >= (ssize_t) 1 << hash->bits && dllist_hash_rehash_(hash, hash->bits + 1) != DLLIST_NONE) {
+            dllist_hash_disable(dllist);
+            return;
+        }
 
+        dllist_hash_add_(dllist, ind);
+    }
+}
 
-dllist_err_t dllist_ctor(dllist_t* dllist, ssize_t init_cpcty, char* log_filename)
+dllist_err_t dllist_order_enable(dllist_t* dllist)
 {
-    utils_assert(dllist);
-    utils_assert(init_cpcty > 0);
+    DLLIST_ASSERT_OK_(dllist);
 
-    IF_DEBUG(
-        utils_assert(log_filename);
-        utils_init_log_file(log_filename, LOG_DIR);
-    )
+    if(dllist->order)
+        return DLLIST_NONE;
 
     dllist_err_t err = DLLIST_NONE;
 
-    ssize_t init_cpcty_vld = 
-        init_cpcty < DLLIST_CPCTY_THREASHOLD_ 
-        ? DLLIST_CPCTY_THREASHOLD_ 
-        : init_cpcty;
+    dllist->order = (dllist_order_t*) calloc(1, sizeof(dllist_order_t));
 
-    err = dllist_realloc_(dllist, init_cpcty_vld);
+    if(!dllist->order)
+        err = DLLIST_ALLOC_FAIL;
     DLLIST_VERIFY_OR_RETURN_(dllist, err);
-    
-    dllist->free = DLLIST_NULL_ + 1;
 
-    dllist->next[DLLIST_NULL_] = DLLIST_NULL_;
-    dllist->prev[DLLIST_NULL_] = DLLIST_NULL_;
-    dllist->size               = 0; 
+    err = dllist_order_fit_(dllist, dllist->cpcty);
 
-    DLLIST_DUMP_(dllist,err);
+    if(err != DLLIST_NONE) {
+        dllist_order_disable(dllist);
+        DLLIST_DUMP_(dllist, err);
+        return err;
+    }
+
+    dllist_order_rebuild_(dllist);
+
+    DLLIST_DUMP_(dllist, err);
 
     return DLLIST_NONE;
 }
 
-void dllist_dtor(dllist_t* dllist)
+void dllist_order_disable(dllist_t* dllist)
 {
     utils_assert(dllist);
 
-    NFREE(dllist->data);
-    NFREE(dllist->next);
-    NFREE(dllist->prev);
-    
-    dllist->size = 0;
-    dllist->free = 0;
+    if(!dllist->order)
+        return;
 
-    IF_DEBUG(
-        utils_end_log();
-    )
+    NFREE(dllist->order->node);
+    NFREE(dllist->order);
 }
 
-static dllist_err_t dllist_realloc_arr_(void** ptr, ssize_t nmemb, size_t tsize)
+// splitmix64 finalizer, priorities must look random in any slot order
+static uint64_t dllist_order_prio_(ssize_t slot)
 {
-    utils_assert(ptr);
-    utils_assert(nmemb > 0);
-
-    void* tmp = 
-        (dllist_data_t*)realloc(*ptr, (unsigned) nmemb * tsize);
+    uint64_t x = (uint64_t) slot + 0x9E3779B97F4A7C15ull;
 
-    if(!tmp) return DLLIST_ALLOC_FAIL;
-
-    *ptr = tmp; 
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
 
-    return DLLIST_NONE;
+    return x ^ (x >> 31);
 }
 
-static dllist_err_t dllist_realloc_(dllist_t* dllist, ssize_t nw_cpcty)
+// Lifts x above its parent, the in-order sequence is kept
+static void dllist_order_rotate_up_(dllist_order_t* order, ssize_t x)
 {
-    utils_assert(dllist);
-    utils_assert(nw_cpcty > dllist->cpcty);
+    ssize_t par = order->node[x].parent;
+    ssize_t gpr = order->node[par].parent;
 
-    dllist_err_t err = DLLIST_NONE;
+    if(order->node[par].left == x) {
+        ssize_t mid = order->node[x].right;
 
-    err = dllist_realloc_arr_(
-        (void**)&dllist->data, 
-        nw_cpcty, 
-        sizeof(dllist->data[0])
-    );
-    DLLIST_VERIFY_OR_RETURN_(dllist, err);
-    
-    memset(
-        dllist->data + dllist->cpcty, 
-        DLLIST_NULL_, 
-        sizeof(dllist->data[0]) * (size_t)(nw_cpcty - dllist->cpcty)
-    );
+        order->node[par].left = DLLIST_IDX_(mid);
+        order->node[x].right  = DLLIST_IDX_(par);
 
-    err = dllist_realloc_arr_(
-        (void**)&dllist->next, 
-        nw_cpcty, 
-        sizeof(dllist->next[0])
-    );
-    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+        if(mid != DLLIST_NULL_)
+            order->node[mid].parent = DLLIST_IDX_(par);
+    }
+    else {
+        ssize_t mid = order->node[x].left;
 
-    for(ssize_t i = dllist->cpcty; i < nw_cpcty - 1; ++i)
-        dllist->next[i] = i + 1;  
-    dllist->next[nw_cpcty - 1] = DLLIST_NULL_;
+        order->node[par].right = DLLIST_IDX_(mid);
+        order->node[x].left    = DLLIST_IDX_(par);
 
-    err = dllist_realloc_arr_(
-        (void**)&dllist->prev, 
-        nw_cpcty, 
-        sizeof(dllist->prev[0])
-    );
-    DLLIST_VERIFY_OR_RETURN_(dllist, err);
-    
-    memset(
-        dllist->prev + dllist->cpcty, 
-        DLLIST_NONE_, 
-        sizeof(dllist->prev[0]) * (size_t)(nw_cpcty - dllist->cpcty)
-    );
+        if(mid != DLLIST_NULL_)
+            order->node[mid].parent = DLLIST_IDX_(par);
+    }
 
-    dllist->cpcty = nw_cpcty;
+    order->node[par].parent = DLLIST_IDX_(x);
+    order->node[x].parent   = DLLIST_IDX_(gpr);
+
+    if(gpr == DLLIST_NULL_)
+        order->root = x;
+    else if(order->node[gpr].left == par)
+        order->node[gpr].left = DLLIST_IDX_(x);
+    else
+        order->node[gpr].right = DLLIST_IDX_(x);
+
+    order->node[x].cnt   = order->node[par].cnt;
+    order->node[par].cnt = 1 + order->node[order->node[par].left].cnt + order->node[order->node[par].right].cnt;
+}
+
+static dllist_err_t dllist_order_fit_(dllist_t* dllist, ssize_t cpcty)
+{
+    dllist_order_t* order = dllist->order;
+
+    if(!order || order->cpcty == cpcty)
+        return DLLIST_NONE;
+
+    void* node = order->node;
+
+    dllist_err_t err = dllist_realloc_arr_(&node, cpcty, sizeof(dllist_order_node_t));
+    if(err != DLLIST_NONE)
+        return err;
+
+    order->node  = (dllist_order_node_t*) node;
+    order->cpcty = cpcty;
 
     return DLLIST_NONE;
 }
 
-dllist_err_t dllist_insert_after(dllist_t* dllist, dllist_data_t val, ssize_t after)
+// The slot has just been linked in right after `after`, so it goes in 
+// as the in-order successor of after and is rotated up by priority
+static void dllist_order_insert_(dllist_t* dllist, ssize_t slot, ssize_t after)
 {
-    DLLIST_ASSERT_OK_(dllist);
+    dllist_order_t* order = dllist->order;
 
-    dllist_err_t err = DLLIST_NONE;
+    if(!order)
+        return;
 
-    IF_DEBUG(
-        if(after > dllist->size)
-            err = DLLIST_OUT_OF_BOUND;
+    order->node[slot].left  = DLLIST_IDX_(DLLIST_NULL_);
+    order->node[slot].right = DLLIST_IDX_(DLLIST_NULL_);
+    order->node[slot].cnt   = 1;
 
-        else if(after < DLLIST_NULL_)
-            err = DLLIST_OUT_OF_BOUND;
+    ssize_t par = DLLIST_NULL_;
 
-        if(err != DLLIST_NONE) {
-            DLLIST_DUMP_(dllist, err);
-            return err;
-        }
-    )
-    
-    if(dllist->free == DLLIST_NULL_) {
-        dllist->free = dllist->cpcty;
-        err = dllist_realloc_(dllist, dllist->cpcty * 2);
-        DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    if(after != DLLIST_NULL_ && order->node[after].right == DLLIST_NULL_) {
+        par = after;
+        order->node[par].right = DLLIST_IDX_(slot);
     }
+    else {
+        par = after == DLLIST_NULL_ ? order->root : order->node[after].right;
 
-    ssize_t cur = dllist->free;
+        while(par != DLLIST_NULL_ && order->node[par].left != DLLIST_NULL_)
+            par = order->node[par].left;
 
-    dllist->data[cur] = val;
-    dllist->free      = dllist->next[cur];
-
-    dllist->next[cur]                 = dllist->next[after];
-    dllist->prev[cur]                 = after;
-    dllist->prev[dllist->next[after]] = cur;
-    dllist->next[after]               = cur;
+        if(par == DLLIST_NULL_)
+            order->root = slot;
+        else
+            order->node[par].left = DLLIST_IDX_(slot);
+    }
 
-    ++dllist->size;
+    order->node[slot].parent = DLLIST_IDX_(par);
 
-    DLLIST_DUMP_(dllist, err);
+    for(ssize_t ind = par; ind != DLLIST_NULL_; ind = order->node[ind].parent)
+        ++order->node[ind].cnt;
 
-    return DLLIST_NONE;
+    while(order->node[slot].parent != DLLIST_NULL_ 
+          && dllist_order_prio_(order->node[slot].parent) < dllist_order_prio_(slot))
+        dllist_order_rotate_up_(order, slot);
 }
 
+// The slot is rotated down to a leaf, always lifting the child of 
+// higher priority, and then cut off
+static void dllist_order_remove_(dllist_t* dllist, ssize_t slot)
+{
+    dllist_order_t* order = dllist->order;
 
-dllist_err_t dllist_delete_at(dllist_t* dllist, ssize_t at)
+    if(!order)
+        return;
+
+    for(;;) {
+        ssize_t lft = order->node[slot].left;
+        ssize_t rgt = order->node[slot].right;
+
+        if(lft == DLLIST_NULL_ && rgt == DLLIST_NULL_)
+            break;
+
+        if(rgt == DLLIST_NULL_ 
+           || (lft != DLLIST_NULL_ && dllist_order_prio_(lft) > dllist_order_prio_(rgt)))
+            dllist_order_rotate_up_(order, lft);
+        else
+            dllist_order_rotate_up_(order, rgt);
+    }
+
+    ssize_t par = order->node[slot].parent;
+
+    if(par == DLLIST_NULL_)
+        order->root = DLLIST_NULL_;
+    else if(order->node[par].left == slot)
+        order->node[par].left = DLLIST_IDX_(DLLIST_NULL_);
+    else
+        order->node[par].right = DLLIST_IDX_(DLLIST_NULL_);
+
+    for(ssize_t ind = par; ind != DLLIST_NULL_; ind = order->node[ind].parent)
+        --order->node[ind].cnt;
+}
+
+// Builds the treap in one pass over the list, keeping its right spine 
+// linked by parent; a node popped off the spine gets no more children, 
+// so its subtree size is final at that point
+static void dllist_order_rebuild_(dllist_t* dllist)
 {
-    DLLIST_ASSERT_OK_(dllist);
+    dllist_order_t* order = dllist->order;
 
-    dllist_err_t err = DLLIST_NONE;
+    if(!order)
+        return;
 
-    IF_DEBUG(
-        if(at > dllist->size)
-            err = DLLIST_OUT_OF_BOUND;
+    order->node[DLLIST_NULL_].cnt = 0;
+    order->root              = DLLIST_NULL_;
 
-        else if(at <= DLLIST_NULL_)
-            err = DLLIST_OUT_OF_BOUND;
+    ssize_t last = DLLIST_NULL_;
 
-        if(err != DLLIST_NONE) {
-            DLLIST_DUMP_(dllist, err);
-            return err;
+    for(ssize_t ind = DLLIST_NEXT(dllist, DLLIST_NULL_); ind != DLLIST_NULL_; ind = DLLIST_NEXT(dllist, ind)) {
+        ssize_t popped = DLLIST_NULL_;
+
+        while(last != DLLIST_NULL_ && dllist_order_prio_(last) < dllist_order_prio_(ind)) {
+            order->node[last].cnt = 1 + order->node[order->node[last].left].cnt + order->node[order->node[last].right].cnt;
+            popped = last;
+            last   = order->node[last].parent;
         }
-    )
 
-    dllist->next[dllist->prev[at]] = dllist->next[at];
-    dllist->prev[dllist->next[at]] = dllist->prev[at];
+        order->node[ind].left   = DLLIST_IDX_(popped);
+        order->node[ind].right  = DLLIST_IDX_(DLLIST_NULL_);
+        order->node[ind].parent = DLLIST_IDX_(last);
 
-    dllist->next[at] = dllist->free;
-    dllist->prev[at] = DLLIST_NONE_;
-    dllist->free     = at;
+        if(popped != DLLIST_NULL_)
+            order->node[popped].parent = DLLIST_IDX_(ind);
 
-    --dllist->size;
+        if(last == DLLIST_NULL_)
+            order->root = ind;
+        else
+            order->node[last].right = DLLIST_IDX_(ind);
 
-    DLLIST_DUMP_(dllist, err);
+        last = ind;
+    }
 
-    return DLLIST_NONE;
+    for(; last != DLLIST_NULL_; last = order->node[last].parent)
+        order->node[last].cnt = 1 + order->node[order->node[last].left].cnt + order->node[order->node[last].right].cnt;
 }
 
-dllist_err_t dllist_linearize(dllist_t* dllist)
+static ssize_t dllist_order_at_(const dllist_order_t* order, ssize_t pos)
 {
-    DLLIST_ASSERT_OK_(dllist);
+    ssize_t ind = order->root;
 
-    dllist_err_t err;
+    while(ind != DLLIST_NULL_) {
+        ssize_t lft = order->node[order->node[ind].left].cnt;
 
-    dllist_data_t* data_tmp = NULL;
-    ssize_t* next_tmp = NULL;
-    ssize_t* prev_tmp = NULL;
+        if(pos <= lft)
+            ind = order->node[ind].left;
+        else if(pos == lft + 1)
+            return ind;
+        else {
+            pos -= lft + 1;
+            ind  = order->node[ind].right;
+        }
+    }
 
-    err = dllist_realloc_arr_((void**)&data_tmp, dllist->size + 1, sizeof(data_tmp[0]));
-    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    return DLLIST_NULL_;
+}
 
-    err = dllist_realloc_arr_((void**)&next_tmp, dllist->size + 1, sizeof(next_tmp[0]));
-    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+static ssize_t dllist_order_pos_(const dllist_order_t* order, ssize_t slot)
+{
+    ssize_t pos = order->node[order->node[slot].left].cnt + 1;
 
-    err = dllist_realloc_arr_((void**)&prev_tmp, dllist->size + 1, sizeof(prev_tmp[0]));
-    DLLIST_VERIFY_OR_RETURN_(dllist, err);
+    for(ssize_t ind = slot; order->node[ind].parent != DLLIST_NULL_; ind = order->node[ind].parent) {
+        ssize_t par = order->node[ind].parent;
 
-    ssize_t ind = DLLIST_NULL_;
-    ssize_t cnt = 0;
-    do {
-        data_tmp[cnt] = dllist->data[ind];
-        next_tmp[cnt] = cnt + 1;
-        prev_tmp[cnt] = cnt - 1;
+        if(order->node[par].right == ind)
+            pos += order->node[order->node[par].left].cnt + 1;
+    }
 
-        ind = dllist->next[ind];
-        cnt++;
-    } while(ind != DLLIST_NULL_);
+    return pos;
+}
 
-    next_tmp[dllist->size] = DLLIST_NULL_;
-    prev_tmp[DLLIST_NULL_] = dllist->size;
-    
-    NFREE(dllist->data);
-    NFREE(dllist->next);
-    NFREE(dllist->prev);
-
-    dllist->data = data_tmp;
-    dllist->next = next_tmp;
-    dllist->prev = prev_tmp;
-    dllist->cpcty = dllist->size + 1;
-    dllist->free = DLLIST_NULL_;
+// Companion indices follow every slot linked into or unlinked from the 
+// list; storage growth reaches them first
+static dllist_err_t dllist_index_fit_(dllist_t* dllist, ssize_t cpcty)
+{
+    dllist_err_t err = dllist_hash_fit_(dllist, cpcty);
 
-    DLLIST_DUMP_(dllist, err);
+    if(err != DLLIST_NONE)
+        return err;
 
-    return DLLIST_NONE;
+    return dllist_order_fit_(dllist, cpcty);
 }
 
-ssize_t dllist_next(dllist_t* dllist, ssize_t after)
+static void dllist_index_link_(dllist_t* dllist, ssize_t slot, ssize_t after)
+{
+    dllist_hash_add_(dllist, slot);
+    dllist_order_insert_(dllist, slot, after);
+}
+
+static void dllist_index_unlink_(dllist_t* dllist, ssize_t slot)
+{
+    dllist_hash_remove_(dllist, slot);
+    dllist_order_remove_(dllist, slot);
+}
+
+static void dllist_index_rebuild_(dllist_t* dllist)
+{
+    dllist_hash_rebuild_(dllist);
+    dllist_order_rebuild_(dllist);
+}
+
+// Positions are 1-based like slots, so on a linear list they coincide; 
+// otherwise the order index is descended, or without it the list is 
+// walked from the nearer end
+ssize_t dllist_at(dllist_t* dllist, ssize_t pos)
 {
     DLLIST_ASSERT_OK_(dllist);
 
     IF_DEBUG(
         dllist_err_t err = DLLIST_NONE; 
 
-        if(after < 0)
+        if(pos <= 0)
             err = DLLIST_OUT_OF_BOUND;
-        else if(after >= dllist->size)
+        else if(pos > dllist->size)
             err = DLLIST_OUT_OF_BOUND;
 
-        if(err != DLLIST_NULL_) {
+        if(err != DLLIST_NONE) {
             DLLIST_DUMP_(dllist, err);
             return err;
         }
     );
 
-    return dllist->next[after];
+    if(dllist->is_linear)
+        return pos;
+
+    if(dllist->order)
+        return dllist_order_at_(dllist->order, pos);
+
+    ssize_t ind = DLLIST_NULL_;
+
+    if(pos <= dllist->size / 2)
+        for(ssize_t i = 0; i < pos; ++i)
+            ind = DLLIST_NEXT(dllist, ind);
+    else
+        for(ssize_t i = dllist->size + 1; i > pos; --i)
+            ind = DLLIST_PREV(dllist, ind);
+
+    return ind;
 }
 
-ssize_t dllist_prev(dllist_t* dllist, ssize_t before)
+ssize_t dllist_pos_of(dllist_t* dllist, ssize_t slot)
 {
     DLLIST_ASSERT_OK_(dllist);
 
     IF_DEBUG(
         dllist_err_t err = DLLIST_NONE; 
 
-        if(before <= 0)
+        if(slot <= DLLIST_NULL_ || slot >= dllist->hwm)
             err = DLLIST_OUT_OF_BOUND;
-        else if(before > dllist->size)
+        else if(DLLIST_PREV(dllist, slot) == DLLIST_NONE_)
             err = DLLIST_OUT_OF_BOUND;
 
-        if(err != DLLIST_NULL_) {
+        if(err != DLLIST_NONE) {
             DLLIST_DUMP_(dllist, err);
             return err;
         }
     );
 
-    return dllist->prev[before];
-}
+    if(dllist->is_linear)
+        return slot;
 
-ssize_t dllist_begin(dllist_t* dllist)
-{
-    DLLIST_ASSERT_OK_(dllist);
+    if(dllist->order)
+        return dllist_order_pos_(dllist->order, slot);
+
+    ssize_t pos = 0;
 
-    return dllist->next[DLLIST_NULL_];
+    for(ssize_t ind = slot; ind != DLLIST_NULL_; ind = DLLIST_PREV(dllist, ind))
+        ++pos;
+
+    return pos;
 }
 
-ssize_t dllist_end(dllist_t* dllist)
+// The new element ends up at position pos, from 1 to size + 1
+dllist_err_t dllist_insert_at_pos(dllist_t* dllist, ssize_t pos, dllist_data_t val)
 {
     DLLIST_ASSERT_OK_(dllist);
 
-    return dllist->prev[DLLIST_NULL_];
+    IF_DEBUG(
+        dllist_err_t err = DLLIST_NONE; 
+
+        if(pos <= 0 || pos > dllist->size + 1)
+            err = DLLIST_OUT_OF_BOUND;
+
+        if(err != DLLIST_NONE) {
+            DLLIST_DUMP_(dllist, err);
+            return err;
+        }
+    );
+
+    ssize_t after = pos == 1 ? DLLIST_NULL_ : dllist_at(dllist, pos - 1);
+
+    return dllist_insert_after(dllist, val, after);
 }
 
 
@@ -419,8 +3725,16 @@ void dllist_dump_(dllist_t* dllist, dllist_err_t err, char* msg, const char* fil
         utils_log_fprintf("\n<table>\n");
 
         utils_log_fprintf("<tr><th>capacity</th><td>%ld</td></tr>\n", dllist->cpcty);
+        utils_log_fprintf("<tr><th>high-water mark</th><td>%ld</td></tr>\n", dllist->hwm);
+        utils_log_fprintf("<tr><th>linear</th><td>%d</td></tr>\n", dllist->is_linear);
         utils_log_fprintf("<tr><th>size</th><td>%ld</td></tr>\n", dllist->size);
 
+        if(dllist->hash)
+            utils_log_fprintf("<tr><th>hashed values</th><td>%ld</td></tr>\n", dllist->hash->used);
+
+        if(dllist->order)
+            utils_log_fprintf("<tr><th>order root</th><td>%ld</td></tr>\n", dllist->order->root);
+
         utils_log_fprintf("\n</table>\n");
 
         if(err == DLLIST_FIELD_NULLPTR)
@@ -430,26 +3744,26 @@ void dllist_dump_(dllist_t* dllist, dllist_err_t err, char* msg, const char* fil
 
         utils_log_fprintf("\n<tr>\n");
         utils_log_fprintf("\n<th>index</th>");
-        for(ssize_t i = 0; i < dllist->cpcty; ++i)
+        for(ssize_t i = 0; i < dllist->hwm; ++i)
             utils_log_fprintf("<td>%ld</td>", i);
         utils_log_fprintf("\n</tr>\n");
 
         utils_log_fprintf("\n<tr>\n");
-        utils_log_fprintf("\n<th>data[%p]</th>", dllist->data);
-        for(ssize_t i = 0; i < dllist->cpcty; ++i)
-            utils_log_fprintf("<td>%d</td>", dllist->data[i]);
+        utils_log_fprintf("\n<th>data[%p]</th>", (void*)&DLLIST_DATA(dllist, 0));
+        for(ssize_t i = 0; i < dllist->hwm; ++i)
+            utils_log_fprintf("<td>%d</td>", DLLIST_DATA(dllist, i));
         utils_log_fprintf("\n</tr>\n");
 
         utils_log_fprintf("\n<tr>\n");
-        utils_log_fprintf("\n<th>next[%p]</th>", dllist->next);
-        for(ssize_t i = 0; i < dllist->cpcty; ++i)
-            utils_log_fprintf("<td>%ld</td>", dllist->next[i]);
+        utils_log_fprintf("\n<th>next[%p]</th>", (void*)&DLLIST_NEXT(dllist, 0));
+        for(ssize_t i = 0; i < dllist->hwm; ++i)
+            utils_log_fprintf("<td>" DLLIST_IDX_FMT_ "</td>", DLLIST_NEXT(dllist, i));
         utils_log_fprintf("\n</tr>\n");
 
         utils_log_fprintf("\n<tr>\n");
-        utils_log_fprintf("\n<th>prev[%p]</th>", dllist->prev);
-        for(ssize_t i = 0; i < dllist->cpcty; ++i)
-            utils_log_fprintf("<td>%ld</td>", dllist->prev[i]);
+        utils_log_fprintf("\n<th>prev[%p]</th>", (void*)&DLLIST_PREV(dllist, 0));
+        for(ssize_t i = 0; i < dllist->hwm; ++i)
+            utils_log_fprintf("<td>" DLLIST_IDX_FMT_ "</td>", DLLIST_PREV(dllist, i));
         utils_log_fprintf("\n</tr>\n");
 
 
@@ -495,51 +3809,51 @@ char* dllist_dump_graphviz_(dllist_t* dllist)
     fprintf(
         file,
         "node_%ld[shape=record,"
-        "label=\"ind: NULL | data: %d | { prev: %ld | next: %ld } \","
+        "label=\"ind: NULL | data: %d | { prev: " DLLIST_IDX_FMT_ " | next: " DLLIST_IDX_FMT_ " } \","
         "color=" CLR_BLUE_BOLD_ ","
         "style=\"filled,bold,rounded\","
         "fillcolor=" CLR_BLUE_LIGHT_ "];\n",
         DLLIST_NULL_,
-        dllist->data[DLLIST_NULL_],
-        dllist->prev[DLLIST_NULL_],
-        dllist->next[DLLIST_NULL_]
+        DLLIST_DATA(dllist, DLLIST_NULL_),
+        DLLIST_PREV(dllist, DLLIST_NULL_),
+        DLLIST_NEXT(dllist, DLLIST_NULL_)
     );
 
-    for(ssize_t node_ind = DLLIST_NULL_ + 1; node_ind < dllist->cpcty; ++node_ind) {
-        if(dllist->prev[node_ind] == DLLIST_NONE_)
+    for(ssize_t node_ind = DLLIST_NULL_ + 1; node_ind < dllist->hwm; ++node_ind) {
+        if(DLLIST_PREV(dllist, node_ind) == DLLIST_NONE_)
             fprintf(
                 file,
                 "node_%ld[shape=record,"
-                "label=\" ind: %ld | data: %d | { prev: %ld | next: %ld } \","
+                "label=\" ind: %ld | data: %d | { prev: " DLLIST_IDX_FMT_ " | next: " DLLIST_IDX_FMT_ " } \","
                 "style=\"filled,rounded\","
                 "color=" CLR_GREEN_BOLD_ ","
                 "fillcolor=" CLR_GREEN_LIGHT_","
                 "constraint=false];\n",  
                 node_ind,
                 node_ind,
-                dllist->data[node_ind],
-                dllist->prev[node_ind],
-                dllist->next[node_ind]
+                DLLIST_DATA(dllist, node_ind),
+                DLLIST_PREV(dllist, node_ind),
+                DLLIST_NEXT(dllist, node_ind)
             );
         else
             fprintf(
                 file,
                 "node_%ld[shape=record,"
-                "label=\" ind: %ld %s %s | data: %d | { prev: %ld | next: %ld } \","
+                "label=\" ind: %ld %s %s | data: %d | { prev: " DLLIST_IDX_FMT_ " | next: " DLLIST_IDX_FMT_ " } \","
                 "color=black,"
                 "fillcolor=white,"
                 "constraint=false];\n",  
                 node_ind,
                 node_ind,
-                node_ind == dllist->next[DLLIST_NULL_] ? "(BEGIN)" : "",
-                node_ind == dllist->prev[DLLIST_NULL_] ? "(END)" : "",
-                dllist->data[node_ind],
-                dllist->prev[node_ind],
-                dllist->next[node_ind]
+                node_ind == DLLIST_NEXT(dllist, DLLIST_NULL_) ? "(BEGIN)" : "",
+                node_ind == DLLIST_PREV(dllist, DLLIST_NULL_) ? "(END)" : "",
+                DLLIST_DATA(dllist, node_ind),
+                DLLIST_PREV(dllist, node_ind),
+                DLLIST_NEXT(dllist, node_ind)
             );
     }
 
-    for(ssize_t node_ind = 0; node_ind < dllist->cpcty - 1; ++node_ind) {
+    for(ssize_t node_ind = 0; node_ind < dllist->hwm - 1; ++node_ind) {
         fprintf(
             file,
             "node_%ld -> node_%ld [weight=1000, style=invis];\n",
@@ -551,66 +3865,66 @@ char* dllist_dump_graphviz_(dllist_t* dllist)
     char* bidir_next_nodes = (char*)calloc((size_t)dllist->cpcty, sizeof(char));
     char* bidir_prev_nodes = (char*)calloc((size_t)dllist->cpcty, sizeof(char));
     
-    for(ssize_t ind = DLLIST_NULL_; ind < dllist->cpcty; ++ind) {
+    for(ssize_t ind = DLLIST_NULL_; ind < dllist->hwm; ++ind) {
         // free
-        if(dllist->prev[ind] == DLLIST_NONE_) {
+        if(DLLIST_PREV(dllist, ind) == DLLIST_NONE_) {
             fprintf(
                 file, 
-                "node_%ld -> node_%ld [color=" CLR_GREEN_BOLD_ "];\n", 
-                ind, dllist->next[ind]
+                "node_%ld -> node_" DLLIST_IDX_FMT_ " [color=" CLR_GREEN_BOLD_ "];\n", 
+                ind, DLLIST_NEXT(dllist, ind)
             );
             continue;
         }
 
-        if(dllist->next[ind] < dllist->cpcty) {
-            if(dllist->prev[dllist->next[ind]] == ind) {
+        if(DLLIST_NEXT(dllist, ind) < dllist->hwm) {
+            if(DLLIST_PREV(dllist, DLLIST_NEXT(dllist, ind)) == ind) {
                 if(!bidir_next_nodes[ind]) {
                     fprintf(
                         file, 
-                        "node_%ld -> node_%ld [dir=both];\n", 
-                        ind, dllist->next[ind]
+                        "node_%ld -> node_" DLLIST_IDX_FMT_ " [dir=both];\n", 
+                        ind, DLLIST_NEXT(dllist, ind)
                     );
-                    bidir_prev_nodes[dllist->next[ind]] = 1;
+                    bidir_prev_nodes[DLLIST_NEXT(dllist, ind)] = 1;
                 }
             }
             else
                 fprintf(
                     file, 
-                    "node_%ld -> node_%ld [color=" CLR_BLUE_BOLD_ "];\n", 
-                    ind, dllist->next[ind]
+                    "node_%ld -> node_" DLLIST_IDX_FMT_ " [color=" CLR_BLUE_BOLD_ "];\n", 
+                    ind, DLLIST_NEXT(dllist, ind)
                 );
         }
         else {
             fprintf(
                 file, 
-                "node_%ld -> node_%ld [style=\"bold\",color=" CLR_RED_BOLD_ "];\n", 
-                ind, dllist->next[ind]
+                "node_%ld -> node_" DLLIST_IDX_FMT_ " [style=\"bold\",color=" CLR_RED_BOLD_ "];\n", 
+                ind, DLLIST_NEXT(dllist, ind)
             );
         }
 
-        if(dllist->prev[ind] < dllist->cpcty) {
-            if(dllist->next[dllist->prev[ind]] == ind) {
+        if(DLLIST_PREV(dllist, ind) < dllist->hwm) {
+            if(DLLIST_NEXT(dllist, DLLIST_PREV(dllist, ind)) == ind) {
                 if(!bidir_prev_nodes[ind]) {
                     fprintf(
                         file, 
-                        "node_%ld -> node_%ld [dir=both];\n", 
-                        dllist->prev[ind], ind
+                        "node_" DLLIST_IDX_FMT_ " -> node_%ld [dir=both];\n", 
+                        DLLIST_PREV(dllist, ind), ind
                     );
-                    bidir_next_nodes[dllist->prev[ind]] = 1;
+                    bidir_next_nodes[DLLIST_PREV(dllist, ind)] = 1;
                 }
             }
             else
                 fprintf(
                     file, 
-                    "node_%ld -> node_%ld [color=" CLR_BLUE_BOLD_ "];\n", 
-                    dllist->prev[ind], ind
+                    "node_" DLLIST_IDX_FMT_ " -> node_%ld [color=" CLR_BLUE_BOLD_ "];\n", 
+                    DLLIST_PREV(dllist, ind), ind
                 );
         }
         else {
             fprintf(
                 file, 
-                "node_%ld -> node_%ld [style=\"bold\",color=" CLR_RED_BOLD_ "];\n", 
-                dllist->prev[ind], ind
+                "node_" DLLIST_IDX_FMT_ " -> node_%ld [style=\"bold\",color=" CLR_RED_BOLD_ "];\n", 
+                DLLIST_PREV(dllist, ind), ind
             );
         }
     }
@@ -655,6 +3969,10 @@ static dllist_err_t dllist_verify_(dllist_t* dllist)
     if(!dllist)
         return DLLIST_NULLPTR;
 
+#ifdef DLLIST_AOS
+    if(!dllist->node)
+        return DLLIST_FIELD_NULLPTR;
+#else // DLLIST_AOS
     if(!dllist->next)
         return DLLIST_FIELD_NULLPTR;
 
@@ -663,6 +3981,7 @@ static dllist_err_t dllist_verify_(dllist_t* dllist)
 
     if(!dllist->prev)
         return DLLIST_FIELD_NULLPTR;
+#endif // DLLIST_AOS
 
     if(dllist->size < 0)
         return DLLIST_BAD_SIZE;
@@ -673,10 +3992,13 @@ static dllist_err_t dllist_verify_(dllist_t* dllist)
     if(dllist->size > dllist->cpcty)
         return DLLIST_SIZE_EXCEED_CPCTY;
 
-    for(ssize_t i = 0; i < dllist->cpcty; ++i) {
-        if(dllist->prev[i] > dllist->cpcty)
+    if(dllist->hwm > dllist->cpcty || dllist->hwm <= dllist->size)
+        return DLLIST_BAD_HWM;
+
+    for(ssize_t i = 0; i < dllist->hwm; ++i) {
+        if(DLLIST_PREV(dllist, i) >= dllist->hwm)
             return DLLIST_BAD_LINK;
-        if(dllist->next[i] > dllist->cpcty)
+        if(DLLIST_NEXT(dllist, i) >= dllist->hwm)
             return DLLIST_BAD_LINK;
     }
 
@@ -690,13 +4012,18 @@ static dllist_err_t dllist_verify_(dllist_t* dllist)
             return DLLIST_INFINIT_NEXT_LOOP;
         }
         
+        if(dllist->is_linear && ind != visited_size) {
+            NFREE(visited);
+            return DLLIST_BAD_LINEAR;
+        }
+
         if(visited_size++ > dllist->size) {
             NFREE(visited);
             return DLLIST_INFINIT_NEXT_LOOP;
         }
 
         visited[ind] = 1;
-        ind = dllist->next[ind];
+        ind = DLLIST_NEXT(dllist, ind);
 
     } while(ind != DLLIST_NULL_);
 
@@ -707,6 +4034,147 @@ static dllist_err_t dllist_verify_(dllist_t* dllist)
 
     NFREE(visited);
 
+    // the holes of a compaction cycle are free, below the high-water mark 
+    // and not below compact_lo
+    if(dllist->compact) {
+        for(ssize_t i = DLLIST_NULL_; i < dllist->cpcty; ++i) {
+            if(!(dllist->compact[i / 64] & (1ull << (i % 64))))
+                continue;
+
+            if(i < dllist->compact_lo || i >= dllist->hwm || DLLIST_PREV(dllist, i) != DLLIST_NONE_)
+                return DLLIST_BAD_HOLE;
+        }
+    }
+
+    if(dllist->freemap) {
+        for(ssize_t i = DLLIST_NULL_; i < dllist->cpcty; ++i) {
+            if(!(dllist->freemap[i / 64] & (1ull << (i % 64))))
+                continue;
+
+            if(i < dllist->freemap_lo || i >= dllist->hwm || DLLIST_PREV(dllist, i) != DLLIST_NONE_)
+                return DLLIST_BAD_HOLE;
+        }
+    }
+
+    dllist_err_t err = DLLIST_NONE;
+
+    if(dllist->hash)
+        err = dllist_verify_hash_(dllist);
+
+    if(err == DLLIST_NONE && dllist->order)
+        err = dllist_verify_order_(dllist);
+
+    return err;
+}
+
+// Every live slot must sit in the chain of its value's bucket, and every 
+// bucket must be reachable by probing
+static dllist_err_t dllist_verify_hash_(dllist_t* dllist)
+{
+    dllist_hash_t* hash = dllist->hash;
+
+    if(!hash->keys || !hash->heads || !hash->hnext || !hash->hprev)
+        return DLLIST_FIELD_NULLPTR;
+
+    if(hash->cpcty < dllist->cpcty)
+        return DLLIST_BAD_HASH;
+
+    ssize_t used = 0;
+    ssize_t cnt  = 0;
+
+    for(size_t i = 0; i < (size_t) 1 << hash->bits; ++i) {
+        if(hash->heads[i] == DLLIST_NULL_)
+            continue;
+
+        if(dllist_hash_probe_(hash, hash->keys[i]) != i)
+            return DLLIST_BAD_HASH;
+
+        ++used;
+
+        ssize_t prv = DLLIST_NULL_;
+
+        for(ssize_t ind = hash->heads[i]; ind != DLLIST_NULL_; ind = hash->hnext[ind]) {
+            if(ind < DLLIST_NULL_ || ind >= dllist->hwm || ++cnt > dllist->size)
+                return DLLIST_BAD_HASH;
+
+            if(DLLIST_PREV(dllist, ind) == DLLIST_NONE_ || DLLIST_DATA(dllist, ind) != hash->keys[i])
+                return DLLIST_BAD_HASH;
+
+            if(hash->hprev[ind] != prv)
+                return DLLIST_BAD_HASH;
+
+            prv = ind;
+        }
+    }
+
+    if(used != hash->used || cnt != dllist->size)
+        return DLLIST_BAD_HASH;
+
+    return DLLIST_NONE;
+}
+
+// The in-order successor of every node must be its list successor, with 
+// consistent parents, subtree sizes and heap order along the way
+static dllist_err_t dllist_verify_order_(dllist_t* dllist)
+{
+    dllist_order_t* order = dllist->order;
+
+    if(!order->node)
+        return DLLIST_FIELD_NULLPTR;
+
+    if(order->cpcty < dllist->cpcty || order->node[DLLIST_NULL_].cnt != 0)
+        return DLLIST_BAD_ORDER;
+
+    ssize_t root = order->root;
+
+    if(root < DLLIST_NULL_ || root >= dllist->hwm || order->node[root].cnt != dllist->size)
+        return DLLIST_BAD_ORDER;
+
+    if(root != DLLIST_NULL_ && order->node[root].parent != DLLIST_NULL_)
+        return DLLIST_BAD_ORDER;
+
+    ssize_t ind = root;
+
+    while(ind != DLLIST_NULL_ && order->node[ind].left != DLLIST_NULL_)
+        ind = order->node[ind].left;
+
+    if(ind != DLLIST_NEXT(dllist, DLLIST_NULL_))
+        return DLLIST_BAD_ORDER;
+
+    for(ind = DLLIST_NEXT(dllist, DLLIST_NULL_); ind != DLLIST_NULL_; ind = DLLIST_NEXT(dllist, ind)) {
+        ssize_t lft = order->node[ind].left;
+        ssize_t rgt = order->node[ind].right;
+
+        if(lft < DLLIST_NULL_ || lft >= dllist->hwm || rgt < DLLIST_NULL_ || rgt >= dllist->hwm)
+            return DLLIST_BAD_ORDER;
+
+        if(order->node[ind].cnt != 1 + order->node[lft].cnt + order->node[rgt].cnt)
+            return DLLIST_BAD_ORDER;
+
+        if(lft != DLLIST_NULL_ && (order->node[lft].parent != ind || dllist_order_prio_(lft) > dllist_order_prio_(ind)))
+            return DLLIST_BAD_ORDER;
+
+        if(rgt != DLLIST_NULL_ && (order->node[rgt].parent != ind || dllist_order_prio_(rgt) > dllist_order_prio_(ind)))
+            return DLLIST_BAD_ORDER;
+
+        ssize_t succ = rgt;
+
+        if(succ != DLLIST_NULL_)
+            while(order->node[succ].left != DLLIST_NULL_)
+                succ = order->node[succ].left;
+        else {
+            succ = ind;
+
+            while(order->node[succ].parent != DLLIST_NULL_ && order->node[order->node[succ].parent].right == succ)
+                succ = order->node[succ].parent;
+
+            succ = order->node[succ].parent;
+        }
+
+        if(succ != DLLIST_NEXT(dllist, ind))
+            return DLLIST_BAD_ORDER;
+    }
+
     return DLLIST_NONE;
 }
 
@@ -735,6 +4203,22 @@ static const char* dllist_strerr_(dllist_err_t err)
             return "bad capacity";
         case DLLIST_SIZE_EXCEED_CPCTY:
             return "size exceeds capacity";
+        case DLLIST_CPCTY_OVERFLOW:
+            return "capacity exceeds index range";
+        case DLLIST_BAD_HWM:
+            return "bad high-water mark";
+        case DLLIST_BAD_LINEAR:
+            return "list marked linear is not";
+        case DLLIST_BAD_HASH:
+            return "hash index out of sync";
+        case DLLIST_BAD_ORDER:
+            return "order index out of sync";
+        case DLLIST_BAD_HOLE:
+            return "compaction hole in use or out of range";
+        case DLLIST_FILE_FAIL:
+            return "snapshot file could not be read or written";
+        case DLLIST_BAD_FILE:
+            return "snapshot file is not one this build can load";
         default:
             return "unknown";
     }
@@ -0,0 +1,293 @@
+#include "dllist_alloc.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "assertutils.h"
+
+static const size_t DLLIST_HUGE_PAGE_ = (size_t) 2 << 20;
+
+static const size_t DLLIST_ARENA_ALIGN_ = 64;
+
+// mbind(2) arguments, spelled out to do without libnuma
+static const int DLLIST_MPOL_BIND_ = 2;
+
+static const int DLLIST_NUMA_MASK_WORDS_ = 16;
+
+static size_t dllist_round_(size_t size, size_t step);
+
+static void* dllist_arena_alloc_(void* ctx, size_t size);
+
+static void* dllist_arena_grow_(void* ctx, void* ptr, size_t old_size, size_t size);
+
+static void dllist_arena_free_(void* ctx, void* ptr, size_t size);
+
+static int dllist_arena_resize_(void* ctx, void* ptr, size_t old_size, size_t size);
+
+static void* dllist_huge_alloc_(void* ctx, size_t size);
+
+static void* dllist_huge_grow_(void* ctx, void* ptr, size_t old_size, size_t size);
+
+static void dllist_huge_free_(void* ctx, void* ptr, size_t size);
+
+static int dllist_huge_resize_(void* ctx, void* ptr, size_t old_size, size_t size);
+
+static int dllist_numa_bind_(void* ptr, size_t len, int node);
+
+static void* dllist_numa_alloc_(void* ctx, size_t size);
+
+static void* dllist_numa_grow_(void* ctx, void* ptr, size_t old_size, size_t size);
+
+static void dllist_numa_free_(void* ctx, void* ptr, size_t size);
+
+
+static size_t dllist_round_(size_t size, size_t step)
+{
+    return (size + step - 1) / step * step;
+}
+
+dllist_err_t dllist_arena_ctor(dllist_arena_t* arena, size_t cpcty)
+{
+    utils_assert(arena);
+
+    arena->cpcty = dllist_round_(cpcty, DLLIST_ARENA_ALIGN_);
+    arena->base  = (char*) aligned_alloc(DLLIST_ARENA_ALIGN_, arena->cpcty);
+    arena->used  = 0;
+    arena->last  = 0;
+
+    if(!arena->base) {
+        arena->cpcty = 0;
+        return DLLIST_ALLOC_FAIL;
+    }
+
+    return DLLIST_NONE;
+}
+
+void dllist_arena_dtor(dllist_arena_t* arena)
+{
+    utils_assert(arena);
+
+    free(arena->base);
+
+    arena->base  = NULL;
+    arena->cpcty = 0;
+    arena->used  = 0;
+    arena->last  = 0;
+}
+
+void dllist_alloc_arena(dllist_alloc_t* alloc, dllist_arena_t* arena)
+{
+    utils_assert(alloc);
+    utils_assert(arena);
+
+    alloc->alloc           = dllist_arena_alloc_;
+    alloc->grow            = dllist_arena_grow_;
+    alloc->free            = dllist_arena_free_;
+    alloc->resize_in_place = dllist_arena_resize_;
+    alloc->ctx             = arena;
+}
+
+static void* dllist_arena_alloc_(void* ctx, size_t size)
+{
+    dllist_arena_t* arena = (dllist_arena_t*) ctx;
+
+    size_t off = dllist_round_(arena->used, DLLIST_ARENA_ALIGN_);
+
+    if(off > arena->cpcty || size > arena->cpcty - off)
+        return NULL;
+
+    arena->last = off;
+    arena->used = off + size;
+
+    return arena->base + off;
+}
+
+static void* dllist_arena_grow_(void* ctx, void* ptr, size_t old_size, size_t size)
+{
+    if(dllist_arena_resize_(ctx, ptr, old_size, size))
+        return ptr;
+
+    void* nw = dllist_arena_alloc_(ctx, size);
+
+    if(nw)
+        memcpy(nw, ptr, old_size < size ? old_size : size);
+
+    return nw;
+}
+
+static void dllist_arena_free_(void* ctx, void* ptr, size_t size)
+{
+    (void) size;
+
+    dllist_arena_t* arena = (dllist_arena_t*) ctx;
+
+    if((char*) ptr == arena->base + arena->last)
+        arena->used = arena->last;
+}
+
+static int dllist_arena_resize_(void* ctx, void* ptr, size_t old_size, size_t size)
+{
+    (void) old_size;
+
+    dllist_arena_t* arena = (dllist_arena_t*) ctx;
+
+    if((char*) ptr != arena->base + arena->last || size > arena->cpcty - arena->last)
+        return 0;
+
+    arena->used = arena->last + size;
+
+    return 1;
+}
+
+void dllist_alloc_huge(dllist_alloc_t* alloc)
+{
+    utils_assert(alloc);
+
+    alloc->alloc           = dllist_huge_alloc_;
+    alloc->grow            = dllist_huge_grow_;
+    alloc->free            = dllist_huge_free_;
+    alloc->resize_in_place = dllist_huge_resize_;
+    alloc->ctx             = NULL;
+}
+
+// Huge pages only back 2 MiB aligned ranges, so one step more is mapped
+// and the ends are cut off
+static void* dllist_huge_alloc_(void* ctx, size_t size)
+{
+    (void) ctx;
+
+    size_t len = dllist_round_(size, DLLIST_HUGE_PAGE_);
+
+    char* map = (char*) mmap(NULL, len + DLLIST_HUGE_PAGE_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if(map == MAP_FAILED)
+        return NULL;
+
+    char* ptr = (char*) dllist_round_((size_t) map, DLLIST_HUGE_PAGE_);
+
+    if(ptr != map)
+        munmap(map, (size_t) (ptr - map));
+
+    munmap(ptr + len, DLLIST_HUGE_PAGE_ - (size_t) (ptr - map));
+
+    (void) madvise(ptr, len, MADV_HUGEPAGE);
+
+    return ptr;
+}
+
+// What cannot grow in place moves its pages into a fresh aligned range,
+// without copying them
+static void* dllist_huge_grow_(void* ctx, void* ptr, size_t old_size, size_t size)
+{
+    if(dllist_huge_resize_(ctx, ptr, old_size, size))
+        return ptr;
+
+    size_t old_len = dllist_round_(old_size, DLLIST_HUGE_PAGE_);
+
+    char* nw = (char*) dllist_huge_alloc_(ctx, size);
+
+    if(!nw)
+        return NULL;
+
+    if(mremap(ptr, old_len, old_len, MREMAP_MAYMOVE | MREMAP_FIXED, nw) == MAP_FAILED) {
+        dllist_huge_free_(ctx, nw, size);
+        return NULL;
+    }
+
+    return nw;
+}
+
+static void dllist_huge_free_(void* ctx, void* ptr, size_t size)
+{
+    (void) ctx;
+
+    munmap(ptr, dllist_round_(size, DLLIST_HUGE_PAGE_));
+}
+
+static int dllist_huge_resize_(void* ctx, void* ptr, size_t old_size, size_t size)
+{
+    (void) ctx;
+
+    size_t old_len = dllist_round_(old_size, DLLIST_HUGE_PAGE_);
+    size_t len     = dllist_round_(size, DLLIST_HUGE_PAGE_);
+
+    if(len == old_len)
+        return 1;
+
+    if(mremap(ptr, old_len, len, 0) == MAP_FAILED)
+        return 0;
+
+    if(len > old_len)
+        (void) madvise((char*) ptr + old_len, len - old_len, MADV_HUGEPAGE);
+
+    return 1;
+}
+
+void dllist_alloc_numa(dllist_alloc_t* alloc, int node)
+{
+    utils_assert(alloc);
+    utils_assert(node >= 0 && node < DLLIST_NUMA_MASK_WORDS_ * 64);
+
+    alloc->alloc           = dllist_numa_alloc_;
+    alloc->grow            = dllist_numa_grow_;
+    alloc->free            = dllist_numa_free_;
+    alloc->resize_in_place = NULL;
+    alloc->ctx             = (void*) (intptr_t) node;
+}
+
+static int dllist_numa_bind_(void* ptr, size_t len, int node)
+{
+    unsigned long mask[DLLIST_NUMA_MASK_WORDS_] = {};
+
+    mask[node / 64] = 1ul << (node % 64);
+
+    // the kernel reads one bit less than maxnode
+    return (int) syscall(SYS_mbind, ptr, len, DLLIST_MPOL_BIND_, mask, (unsigned long) DLLIST_NUMA_MASK_WORDS_ * 64 + 1, 0u);
+}
+
+static void* dllist_numa_alloc_(void* ctx, size_t size)
+{
+    size_t len = dllist_round_(size, (size_t) sysconf(_SC_PAGESIZE));
+
+    void* ptr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if(ptr == MAP_FAILED)
+        return NULL;
+
+    if(dllist_numa_bind_(ptr, len, (int) (intptr_t) ctx) != 0) {
+        munmap(ptr, len);
+        return NULL;
+    }
+
+    return ptr;
+}
+
+// Pages already placed stay where they are, the new ones follow the
+// policy set again over the whole range
+static void* dllist_numa_grow_(void* ctx, void* ptr, size_t old_size, size_t size)
+{
+    size_t page    = (size_t) sysconf(_SC_PAGESIZE);
+    size_t old_len = dllist_round_(old_size, page);
+    size_t len     = dllist_round_(size, page);
+
+    void* nw = mremap(ptr, old_len, len, MREMAP_MAYMOVE);
+
+    if(nw == MAP_FAILED)
+        return NULL;
+
+    if(len > old_len)
+        (void) dllist_numa_bind_(nw, len, (int) (intptr_t) ctx);
+
+    return nw;
+}
+
+static void dllist_numa_free_(void* ctx, void* ptr, size_t size)
+{
+    (void) ctx;
+
+    munmap(ptr, dllist_round_(size, (size_t) sysconf(_SC_PAGESIZE)));
+}
@@ -0,0 +1,303 @@
+#include "dllist_concurrent.h"
+
+#include <stdlib.h>
+
+#include "assertutils.h"
+
+static const ssize_t DLLIST_CONCURRENT_NULL_ = 0;
+
+// prev of a free slot, as in dllist.c
+static const ssize_t DLLIST_CONCURRENT_FREE_ = -1;
+
+#ifdef DLLIST_IDX32
+#define DLLIST_CONCURRENT_IDX_(val) ((dllist_idx_t)(val))
+#else // DLLIST_IDX32
+#define DLLIST_CONCURRENT_IDX_(val) (val)
+#endif // DLLIST_IDX32
+
+// Links are read speculatively before their stripes are locked, so every
+// link access in this file is atomic; the stripe locks order them
+#define DLLIST_CONCURRENT_LOAD_(link) \
+    __atomic_load_n(&(link), __ATOMIC_RELAXED)
+
+#define DLLIST_CONCURRENT_STORE_(link, val) \
+    __atomic_store_n(&(link), DLLIST_CONCURRENT_IDX_(val), __ATOMIC_RELAXED)
+
+// stripes held by one operation, ascending and unique
+typedef struct dllist_concurrent_held_t_
+{
+    size_t stripe[3];
+    int cnt;
+
+} dllist_concurrent_held_t_;
+
+static void dllist_concurrent_lock_(dllist_concurrent_t* clist, dllist_concurrent_held_t_* held, const ssize_t* nodes, int n);
+
+static void dllist_concurrent_unlock_(dllist_concurrent_t* clist, dllist_concurrent_held_t_* held);
+
+static dllist_err_t dllist_concurrent_refill_(dllist_concurrent_t* clist, dllist_concurrent_ctx_t* ctx);
+
+static void dllist_concurrent_spill_(dllist_concurrent_t* clist, dllist_concurrent_ctx_t* ctx);
+
+
+dllist_err_t dllist_concurrent_ctor(dllist_concurrent_t* clist, ssize_t init_cpcty, char* log_filename)
+{
+    utils_assert(clist);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    err = dllist_ctor(&clist->list, init_cpcty, log_filename);
+    if(err != DLLIST_NONE)
+        return err;
+
+    // threads link their slots wherever they insert
+    clist->list.is_linear = 0;
+
+    pthread_rwlock_init(&clist->grow_lock, NULL);
+
+    for(size_t i = 0; i < DLLIST_CONCURRENT_STRIPES; ++i)
+        pthread_mutex_init(&clist->stripe[i].mutex, NULL);
+
+    return DLLIST_NONE;
+}
+
+void dllist_concurrent_dtor(dllist_concurrent_t* clist)
+{
+    utils_assert(clist);
+
+    for(size_t i = 0; i < DLLIST_CONCURRENT_STRIPES; ++i)
+        pthread_mutex_destroy(&clist->stripe[i].mutex);
+
+    pthread_rwlock_destroy(&clist->grow_lock);
+
+    dllist_dtor(&clist->list);
+}
+
+void dllist_concurrent_ctx_init(dllist_concurrent_ctx_t* ctx)
+{
+    utils_assert(ctx);
+
+    ctx->cnt = 0;
+}
+
+void dllist_concurrent_ctx_flush(dllist_concurrent_t* clist, dllist_concurrent_ctx_t* ctx)
+{
+    utils_assert(clist);
+    utils_assert(ctx);
+
+    if(ctx->cnt == 0)
+        return;
+
+    pthread_rwlock_wrlock(&clist->grow_lock);
+
+    dllist_release_slots(&clist->list, ctx->slots, ctx->cnt);
+
+    pthread_rwlock_unlock(&clist->grow_lock);
+
+    ctx->cnt = 0;
+}
+
+// Half a cache is taken at once, so that a thread alternating inserts
+// and deletes does not go back to the shared free list every time
+static dllist_err_t dllist_concurrent_refill_(dllist_concurrent_t* clist, dllist_concurrent_ctx_t* ctx)
+{
+    dllist_err_t err = DLLIST_NONE;
+
+    pthread_rwlock_wrlock(&clist->grow_lock);
+
+    err = dllist_take_slots(&clist->list, ctx->slots, DLLIST_CONCURRENT_CACHE / 2);
+
+    pthread_rwlock_unlock(&clist->grow_lock);
+
+    if(err == DLLIST_NONE)
+        ctx->cnt = DLLIST_CONCURRENT_CACHE / 2;
+
+    return err;
+}
+
+static void dllist_concurrent_spill_(dllist_concurrent_t* clist, dllist_concurrent_ctx_t* ctx)
+{
+    pthread_rwlock_wrlock(&clist->grow_lock);
+
+    dllist_release_slots(
+        &clist->list,
+        ctx->slots + DLLIST_CONCURRENT_CACHE / 2,
+        DLLIST_CONCURRENT_CACHE - DLLIST_CONCURRENT_CACHE / 2
+    );
+
+    pthread_rwlock_unlock(&clist->grow_lock);
+
+    ctx->cnt = DLLIST_CONCURRENT_CACHE / 2;
+}
+
+// Stripes are always taken in ascending order, so two operations
+// locking overlapping sets cannot deadlock
+static void dllist_concurrent_lock_(dllist_concurrent_t* clist, dllist_concurrent_held_t_* held, const ssize_t* nodes, int n)
+{
+    size_t stripe[3] = {};
+
+    for(int i = 0; i < n; ++i) {
+        size_t cur = (size_t) nodes[i] % DLLIST_CONCURRENT_STRIPES;
+        int    j   = i;
+
+        for(; j > 0 && stripe[j - 1] > cur; --j)
+            stripe[j] = stripe[j - 1];
+
+        stripe[j] = cur;
+    }
+
+    held->cnt = 0;
+
+    for(int i = 0; i < n; ++i)
+        if(held->cnt == 0 || held->stripe[held->cnt - 1] != stripe[i])
+            held->stripe[held->cnt++] = stripe[i];
+
+    for(int i = 0; i < held->cnt; ++i)
+        pthread_mutex_lock(&clist->stripe[held->stripe[i]].mutex);
+}
+
+static void dllist_concurrent_unlock_(dllist_concurrent_t* clist, dllist_concurrent_held_t_* held)
+{
+    for(int i = held->cnt - 1; i >= 0; --i)
+        pthread_mutex_unlock(&clist->stripe[held->stripe[i]].mutex);
+}
+
+// The links of `after` and its successor are written with their stripes
+// held. Those of the new node are not: no other thread can reach it
+// before a link of its neighbours points to it, and those are stored
+// after its own. The successor of `after` is read unlocked, both
+// stripes are locked and the read is retried if the successor changed
+// in between
+dllist_err_t dllist_concurrent_insert_after(dllist_concurrent_t* clist, dllist_concurrent_ctx_t* ctx, dllist_data_t val, ssize_t after, ssize_t* slot)
+{
+    utils_assert(clist);
+    utils_assert(ctx);
+
+    dllist_err_t err = DLLIST_NONE;
+    dllist_t*    list = &clist->list;
+
+    if(ctx->cnt == 0) {
+        err = dllist_concurrent_refill_(clist, ctx);
+        if(err != DLLIST_NONE)
+            return err;
+    }
+
+    ssize_t cur = ctx->slots[--ctx->cnt];
+
+    pthread_rwlock_rdlock(&clist->grow_lock);
+
+    IF_DEBUG(
+        if(after < DLLIST_CONCURRENT_NULL_ || after >= list->hwm)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else if(DLLIST_CONCURRENT_LOAD_(DLLIST_PREV(list, after)) == DLLIST_CONCURRENT_FREE_)
+            err = DLLIST_OUT_OF_BOUND;
+
+        if(err != DLLIST_NONE) {
+            pthread_rwlock_unlock(&clist->grow_lock);
+            ctx->slots[ctx->cnt++] = cur;
+            return err;
+        }
+    )
+
+    DLLIST_DATA(list, cur) = val;
+
+    dllist_concurrent_held_t_ held = {};
+    ssize_t nxt = DLLIST_CONCURRENT_NULL_;
+
+    for(;;) {
+        nxt = DLLIST_CONCURRENT_LOAD_(DLLIST_NEXT(list, after));
+
+        ssize_t nodes[] = {after, nxt};
+        dllist_concurrent_lock_(clist, &held, nodes, 2);
+
+        if(DLLIST_CONCURRENT_LOAD_(DLLIST_NEXT(list, after)) == nxt)
+            break;
+
+        dllist_concurrent_unlock_(clist, &held);
+    }
+
+    DLLIST_CONCURRENT_STORE_(DLLIST_NEXT(list, cur),   nxt);
+    DLLIST_CONCURRENT_STORE_(DLLIST_PREV(list, cur),   after);
+    DLLIST_CONCURRENT_STORE_(DLLIST_PREV(list, nxt),   cur);
+    DLLIST_CONCURRENT_STORE_(DLLIST_NEXT(list, after), cur);
+
+    dllist_concurrent_unlock_(clist, &held);
+
+    __atomic_add_fetch(&list->size, 1, __ATOMIC_RELAXED);
+
+    pthread_rwlock_unlock(&clist->grow_lock);
+
+    if(slot)
+        *slot = cur;
+
+    return DLLIST_NONE;
+}
+
+dllist_err_t dllist_concurrent_delete_at(dllist_concurrent_t* clist, dllist_concurrent_ctx_t* ctx, ssize_t at)
+{
+    utils_assert(clist);
+    utils_assert(ctx);
+
+    dllist_t* list = &clist->list;
+
+    pthread_rwlock_rdlock(&clist->grow_lock);
+
+    IF_DEBUG(
+        dllist_err_t err = DLLIST_NONE;
+
+        if(at <= DLLIST_CONCURRENT_NULL_ || at >= list->hwm)
+            err = DLLIST_OUT_OF_BOUND;
+
+        else if(DLLIST_CONCURRENT_LOAD_(DLLIST_PREV(list, at)) == DLLIST_CONCURRENT_FREE_)
+            err = DLLIST_OUT_OF_BOUND;
+
+        if(err != DLLIST_NONE) {
+            pthread_rwlock_unlock(&clist->grow_lock);
+            return err;
+        }
+    )
+
+    dllist_concurrent_held_t_ held = {};
+    ssize_t prv = DLLIST_CONCURRENT_NULL_;
+    ssize_t nxt = DLLIST_CONCURRENT_NULL_;
+
+    for(;;) {
+        prv = DLLIST_CONCURRENT_LOAD_(DLLIST_PREV(list, at));
+        nxt = DLLIST_CONCURRENT_LOAD_(DLLIST_NEXT(list, at));
+
+        ssize_t nodes[] = {prv, at, nxt};
+        dllist_concurrent_lock_(clist, &held, nodes, 3);
+
+        if(DLLIST_CONCURRENT_LOAD_(DLLIST_PREV(list, at)) == prv
+           && DLLIST_CONCURRENT_LOAD_(DLLIST_NEXT(list, at)) == nxt)
+            break;
+
+        dllist_concurrent_unlock_(clist, &held);
+    }
+
+    DLLIST_CONCURRENT_STORE_(DLLIST_NEXT(list, prv), nxt);
+    DLLIST_CONCURRENT_STORE_(DLLIST_PREV(list, nxt), prv);
+    DLLIST_CONCURRENT_STORE_(DLLIST_NEXT(list, at),  DLLIST_CONCURRENT_NULL_);
+    DLLIST_CONCURRENT_STORE_(DLLIST_PREV(list, at),  DLLIST_CONCURRENT_FREE_);
+
+    dllist_concurrent_unlock_(clist, &held);
+
+    __atomic_sub_fetch(&list->size, 1, __ATOMIC_RELAXED);
+
+    pthread_rwlock_unlock(&clist->grow_lock);
+
+    if(ctx->cnt == DLLIST_CONCURRENT_CACHE)
+        dllist_concurrent_spill_(clist, ctx);
+
+    ctx->slots[ctx->cnt++] = at;
+
+    return DLLIST_NONE;
+}
+
+ssize_t dllist_concurrent_size(dllist_concurrent_t* clist)
+{
+    utils_assert(clist);
+
+    return __atomic_load_n(&clist->list.size, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,271 @@
+#include "dllist_pool.h"
+
+#include <unistd.h>
+
+#include "memutils.h"
+#include "assertutils.h"
+
+typedef struct dllist_pool_arg_t_
+{
+    dllist_pool_t* pool;
+    int worker;
+
+} dllist_pool_arg_t_;
+
+typedef struct dllist_pool_for_t_
+{
+    dllist_pool_t* pool;
+
+    dllist_pool_range_t body;
+    void* ctx;
+
+    ssize_t grain;
+
+} dllist_pool_for_t_;
+
+static void* dllist_pool_worker_(void* arg);
+
+static int dllist_pool_pop_(dllist_pool_deque_t* deque, ssize_t grain, ssize_t* lo, ssize_t* hi);
+
+static int dllist_pool_steal_(dllist_pool_deque_t* victim, dllist_pool_deque_t* own, ssize_t grain);
+
+static void dllist_pool_for_job_(void* arg, int worker, int nworkers);
+
+
+dllist_err_t dllist_pool_ctor(dllist_pool_t* pool, int nthreads)
+{
+    utils_assert(pool);
+    utils_assert(nthreads >= 0);
+
+    if(nthreads == 0) {
+        long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+        nthreads = ncpu > 0 ? (int) ncpu : 1;
+    }
+
+    pool->nthreads = nthreads;
+    pool->job      = NULL;
+    pool->ctx      = NULL;
+    pool->gen      = 0;
+    pool->pending  = 0;
+    pool->stop     = 0;
+
+    pool->thread = (pthread_t*) calloc((size_t) nthreads, sizeof(pthread_t));
+    pool->deque  = (dllist_pool_deque_t*) aligned_alloc(alignof(dllist_pool_deque_t), (size_t) nthreads * sizeof(dllist_pool_deque_t));
+
+    if(!pool->thread || !pool->deque) {
+        NFREE(pool->thread);
+        NFREE(pool->deque);
+
+        return DLLIST_ALLOC_FAIL;
+    }
+
+    for(int i = 0; i < nthreads; ++i) {
+        pthread_mutex_init(&pool->deque[i].mutex, NULL);
+
+        pool->deque[i].lo = 0;
+        pool->deque[i].hi = 0;
+    }
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    // worker 0 is whoever calls dllist_pool_run
+    for(int i = 1; i < nthreads; ++i) {
+        dllist_pool_arg_t_* arg = (dllist_pool_arg_t_*) calloc(1, sizeof(dllist_pool_arg_t_));
+
+        if(arg) {
+            arg->pool   = pool;
+            arg->worker = i;
+        }
+
+        if(!arg || pthread_create(&pool->thread[i], NULL, dllist_pool_worker_, arg) != 0) {
+            free(arg);
+
+            // only the threads started so far are joined by the dtor
+            for(int j = i; j < nthreads; ++j)
+                pthread_mutex_destroy(&pool->deque[j].mutex);
+
+            pool->nthreads = i;
+            dllist_pool_dtor(pool);
+
+            return DLLIST_ALLOC_FAIL;
+        }
+    }
+
+    return DLLIST_NONE;
+}
+
+void dllist_pool_dtor(dllist_pool_t* pool)
+{
+    utils_assert(pool);
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for(int i = 1; i < pool->nthreads; ++i)
+        pthread_join(pool->thread[i], NULL);
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->mutex);
+
+    for(int i = 0; i < pool->nthreads; ++i)
+        pthread_mutex_destroy(&pool->deque[i].mutex);
+
+    NFREE(pool->thread);
+    NFREE(pool->deque);
+
+    pool->nthreads = 0;
+}
+
+static void* dllist_pool_worker_(void* arg)
+{
+    dllist_pool_t* pool   = ((dllist_pool_arg_t_*) arg)->pool;
+    int            worker = ((dllist_pool_arg_t_*) arg)->worker;
+
+    free(arg);
+
+    long seen = 0;
+
+    for(;;) {
+        pthread_mutex_lock(&pool->mutex);
+
+        while(!pool->stop && pool->gen == seen)
+            pthread_cond_wait(&pool->start, &pool->mutex);
+
+        if(pool->stop) {
+            pthread_mutex_unlock(&pool->mutex);
+            return NULL;
+        }
+
+        seen = pool->gen;
+
+        dllist_pool_job_t job = pool->job;
+        void*             ctx = pool->ctx;
+
+        pthread_mutex_unlock(&pool->mutex);
+
+        job(ctx, worker, pool->nthreads);
+
+        pthread_mutex_lock(&pool->mutex);
+
+        if(--pool->pending == 0)
+            pthread_cond_signal(&pool->done);
+
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+void dllist_pool_run(dllist_pool_t* pool, dllist_pool_job_t job, void* ctx)
+{
+    utils_assert(pool);
+    utils_assert(job);
+
+    pthread_mutex_lock(&pool->mutex);
+
+    pool->job     = job;
+    pool->ctx     = ctx;
+    pool->pending = pool->nthreads - 1;
+    ++pool->gen;
+
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    job(ctx, 0, pool->nthreads);
+
+    pthread_mutex_lock(&pool->mutex);
+
+    while(pool->pending != 0)
+        pthread_cond_wait(&pool->done, &pool->mutex);
+
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+void dllist_pool_for(dllist_pool_t* pool, ssize_t n, ssize_t grain, dllist_pool_range_t body, void* ctx)
+{
+    utils_assert(pool);
+    utils_assert(body);
+    utils_assert(n >= 0);
+    utils_assert(grain > 0);
+
+    for(int i = 0; i < pool->nthreads; ++i) {
+        pool->deque[i].lo = DLLIST_POOL_LO(n, i, pool->nthreads);
+        pool->deque[i].hi = DLLIST_POOL_HI(n, i, pool->nthreads);
+    }
+
+    dllist_pool_for_t_ arg = {pool, body, ctx, grain};
+
+    dllist_pool_run(pool, dllist_pool_for_job_, &arg);
+}
+
+// Ranges only ever shrink or move to a thief, so a worker that finds 
+// every other deque empty in one sweep has nothing left to help with
+static void dllist_pool_for_job_(void* arg, int worker, int nworkers)
+{
+    dllist_pool_for_t_*  fr    = (dllist_pool_for_t_*) arg;
+    dllist_pool_deque_t* deque = fr->pool->deque;
+
+    ssize_t lo = 0;
+    ssize_t hi = 0;
+
+    for(;;) {
+        while(dllist_pool_pop_(&deque[worker], fr->grain, &lo, &hi))
+            fr->body(fr->ctx, worker, lo, hi);
+
+        int stolen = 0;
+
+        for(int i = 1; i < nworkers && !stolen; ++i)
+            stolen = dllist_pool_steal_(&deque[(worker + i) % nworkers], &deque[worker], fr->grain);
+
+        if(!stolen)
+            return;
+    }
+}
+
+static int dllist_pool_pop_(dllist_pool_deque_t* deque, ssize_t grain, ssize_t* lo, ssize_t* hi)
+{
+    pthread_mutex_lock(&deque->mutex);
+
+    int found = deque->lo < deque->hi;
+
+    if(found) {
+        *lo = deque->lo;
+        *hi = deque->hi - deque->lo > grain ? deque->lo + grain : deque->hi;
+
+        deque->lo = *hi;
+    }
+
+    pthread_mutex_unlock(&deque->mutex);
+
+    return found;
+}
+
+// The thief takes the back half, the owner keeps eating the front
+static int dllist_pool_steal_(dllist_pool_deque_t* victim, dllist_pool_deque_t* own, ssize_t grain)
+{
+    pthread_mutex_lock(&victim->mutex);
+
+    ssize_t left = victim->hi - victim->lo;
+    ssize_t take = left > grain ? left / 2 : left;
+    ssize_t lo   = victim->hi - take;
+
+    victim->hi = lo;
+
+    pthread_mutex_unlock(&victim->mutex);
+
+    if(take == 0)
+        return 0;
+
+    pthread_mutex_lock(&own->mutex);
+
+    own->lo = lo;
+    own->hi = lo + take;
+
+    pthread_mutex_unlock(&own->mutex);
+
+    return 1;
+}
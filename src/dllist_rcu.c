@@ -0,0 +1,361 @@
+#include "dllist_rcu.h"
+
+#include <memory.h>
+#include <stdlib.h>
+
+#include "memutils.h"
+#include "assertutils.h"
+
+static const ssize_t DLLIST_RCU_NULL_ = 0;
+
+static const ssize_t DLLIST_RCU_NONE_ = -1;
+
+static const ssize_t DLLIST_RCU_CPCTY_THREASHOLD_ = 5;
+
+#ifdef DLLIST_IDX32
+#define DLLIST_RCU_IDX_(val) ((dllist_idx_t)(val))
+#else // DLLIST_IDX32
+#define DLLIST_RCU_IDX_(val) (val)
+#endif // DLLIST_IDX32
+
+// readers may be walking next[] while the writer stores to it
+#define DLLIST_RCU_PUBLISH_(link, val) \
+    __atomic_store_n(&(link), DLLIST_RCU_IDX_(val), __ATOMIC_RELEASE)
+
+static dllist_rcu_buf_t* dllist_rcu_buf_alloc_(ssize_t cpcty);
+
+static dllist_err_t dllist_rcu_grow_(dllist_rcu_t* rcu);
+
+static dllist_err_t dllist_rcu_take_slot_(dllist_rcu_t* rcu, ssize_t* slot);
+
+static dllist_err_t dllist_rcu_retired_fit_(dllist_rcu_t* rcu);
+
+static void dllist_rcu_retire_(dllist_rcu_t* rcu, ssize_t slot);
+
+static ssize_t dllist_rcu_min_epoch_(dllist_rcu_t* rcu);
+
+
+dllist_err_t dllist_rcu_ctor(dllist_rcu_t* rcu, ssize_t init_cpcty)
+{
+    utils_assert(rcu);
+    utils_assert(init_cpcty > 0);
+
+    ssize_t init_cpcty_vld =
+        init_cpcty < DLLIST_RCU_CPCTY_THREASHOLD_
+        ? DLLIST_RCU_CPCTY_THREASHOLD_
+        : init_cpcty;
+
+    memset(rcu, 0, sizeof(*rcu));
+
+    rcu->buf = dllist_rcu_buf_alloc_(init_cpcty_vld);
+
+    if(!rcu->buf)
+        return DLLIST_ALLOC_FAIL;
+
+    rcu->buf->next[DLLIST_RCU_NULL_] = DLLIST_RCU_NULL_;
+    rcu->buf->prev[DLLIST_RCU_NULL_] = DLLIST_RCU_NULL_;
+    rcu->buf->data[DLLIST_RCU_NULL_] = 0;
+
+    rcu->epoch = 1;
+    rcu->free  = DLLIST_RCU_NULL_;
+    rcu->hwm   = DLLIST_RCU_NULL_ + 1;
+    rcu->size  = 0;
+
+    return DLLIST_NONE;
+}
+
+// No reader may be registered any more
+void dllist_rcu_dtor(dllist_rcu_t* rcu)
+{
+    utils_assert(rcu);
+
+    for(ssize_t i = 0; i < rcu->old_cnt; ++i)
+        NFREE(rcu->old_buf[i]);
+
+    NFREE(rcu->buf);
+    NFREE(rcu->retired);
+
+    rcu->old_cnt       = 0;
+    rcu->retired_cnt   = 0;
+    rcu->retired_cpcty = 0;
+    rcu->size          = 0;
+    rcu->hwm           = 0;
+    rcu->free          = 0;
+}
+
+// The buffer header and its arrays share one allocation, widest first
+static dllist_rcu_buf_t* dllist_rcu_buf_alloc_(ssize_t cpcty)
+{
+    size_t arrays = (size_t) cpcty * (sizeof(dllist_idx_t) * 2 + sizeof(dllist_data_t));
+
+    char* base = (char*) malloc(sizeof(dllist_rcu_buf_t) + arrays);
+
+    if(!base)
+        return NULL;
+
+    dllist_rcu_buf_t* buf = (dllist_rcu_buf_t*) base;
+    base += sizeof(dllist_rcu_buf_t);
+
+    buf->next  = (dllist_idx_t*)  base;
+    buf->prev  = (dllist_idx_t*)  (base + (size_t) cpcty * sizeof(dllist_idx_t));
+    buf->data  = (dllist_data_t*) (base + (size_t) cpcty * sizeof(dllist_idx_t) * 2);
+    buf->cpcty = cpcty;
+
+    return buf;
+}
+
+// The nodes are copied into a buffer twice as large which is then
+// published; readers already inside keep walking the old one, which is
+// freed once they are gone
+static dllist_err_t dllist_rcu_grow_(dllist_rcu_t* rcu)
+{
+    utils_assert(rcu->old_cnt < (ssize_t) (sizeof(rcu->old_buf) / sizeof(rcu->old_buf[0])));
+
+    dllist_rcu_buf_t* old = rcu->buf;
+    dllist_rcu_buf_t* nw  = dllist_rcu_buf_alloc_(old->cpcty * 2);
+
+    if(!nw)
+        return DLLIST_ALLOC_FAIL;
+
+    memcpy(nw->next, old->next, sizeof(old->next[0]) * (size_t) rcu->hwm);
+    memcpy(nw->prev, old->prev, sizeof(old->prev[0]) * (size_t) rcu->hwm);
+    memcpy(nw->data, old->data, sizeof(old->data[0]) * (size_t) rcu->hwm);
+
+    __atomic_store_n(&rcu->buf, nw, __ATOMIC_RELEASE);
+
+    rcu->old_buf[rcu->old_cnt]   = old;
+    rcu->old_epoch[rcu->old_cnt] = __atomic_fetch_add(&rcu->epoch, 1, __ATOMIC_SEQ_CST);
+    ++rcu->old_cnt;
+
+    return DLLIST_NONE;
+}
+
+static dllist_err_t dllist_rcu_take_slot_(dllist_rcu_t* rcu, ssize_t* slot)
+{
+    dllist_err_t err = DLLIST_NONE;
+
+    if(rcu->free == DLLIST_RCU_NULL_ && rcu->hwm == rcu->buf->cpcty)
+        dllist_rcu_reclaim(rcu);
+
+    if(rcu->free != DLLIST_RCU_NULL_) {
+        *slot     = rcu->free;
+        rcu->free = rcu->buf->next[*slot];
+
+        return DLLIST_NONE;
+    }
+
+    if(rcu->hwm == rcu->buf->cpcty) {
+        err = dllist_rcu_grow_(rcu);
+        if(err != DLLIST_NONE)
+            return err;
+    }
+
+    *slot = rcu->hwm++;
+
+    return DLLIST_NONE;
+}
+
+// The new node is filled in completely before the release store of
+// next[after] makes it reachable
+dllist_err_t dllist_rcu_insert_after(dllist_rcu_t* rcu, dllist_data_t val, ssize_t after, ssize_t* slot)
+{
+    utils_assert(rcu);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    IF_DEBUG(
+        if(after < DLLIST_RCU_NULL_ || after >= rcu->hwm)
+            return DLLIST_OUT_OF_BOUND;
+
+        if(rcu->buf->prev[after] == DLLIST_RCU_NONE_)
+            return DLLIST_OUT_OF_BOUND;
+    )
+
+    ssize_t cur = DLLIST_RCU_NULL_;
+
+    err = dllist_rcu_take_slot_(rcu, &cur);
+    if(err != DLLIST_NONE)
+        return err;
+
+    dllist_rcu_buf_t* buf = rcu->buf;
+    ssize_t           nxt = buf->next[after];
+
+    buf->data[cur] = val;
+    buf->prev[cur] = DLLIST_RCU_IDX_(after);
+    DLLIST_RCU_PUBLISH_(buf->next[cur], nxt);
+
+    DLLIST_RCU_PUBLISH_(buf->next[after], cur);
+    buf->prev[nxt] = DLLIST_RCU_IDX_(cur);
+
+    ++rcu->size;
+
+    if(slot)
+        *slot = cur;
+
+    return DLLIST_NONE;
+}
+
+// next[at] is left intact so that a reader standing on at walks on
+dllist_err_t dllist_rcu_delete_at(dllist_rcu_t* rcu, ssize_t at)
+{
+    utils_assert(rcu);
+
+    IF_DEBUG(
+        if(at <= DLLIST_RCU_NULL_ || at >= rcu->hwm)
+            return DLLIST_OUT_OF_BOUND;
+
+        if(rcu->buf->prev[at] == DLLIST_RCU_NONE_)
+            return DLLIST_OUT_OF_BOUND;
+    )
+
+    dllist_err_t err = dllist_rcu_retired_fit_(rcu);
+    if(err != DLLIST_NONE)
+        return err;
+
+    dllist_rcu_buf_t* buf = rcu->buf;
+
+    ssize_t prv = buf->prev[at];
+    ssize_t nxt = buf->next[at];
+
+    DLLIST_RCU_PUBLISH_(buf->next[prv], nxt);
+    buf->prev[nxt] = DLLIST_RCU_IDX_(prv);
+
+    --rcu->size;
+
+    dllist_rcu_retire_(rcu, at);
+
+    return DLLIST_NONE;
+}
+
+// Grown before the unlink, so a failed allocation leaves the list intact
+static dllist_err_t dllist_rcu_retired_fit_(dllist_rcu_t* rcu)
+{
+    if(rcu->retired_cnt < rcu->retired_cpcty)
+        return DLLIST_NONE;
+
+    ssize_t nw_cpcty = rcu->retired_cpcty ? rcu->retired_cpcty * 2 : DLLIST_RCU_RECLAIM_BATCH;
+
+    void* tmp = realloc(rcu->retired, (size_t) nw_cpcty * sizeof(rcu->retired[0]));
+
+    if(!tmp)
+        return DLLIST_ALLOC_FAIL;
+
+    rcu->retired       = (dllist_rcu_retired_t*) tmp;
+    rcu->retired_cpcty = nw_cpcty;
+
+    return DLLIST_NONE;
+}
+
+static void dllist_rcu_retire_(dllist_rcu_t* rcu, ssize_t slot)
+{
+    // readers entering from now on cannot reach the slot
+    rcu->buf->prev[slot] = DLLIST_RCU_IDX_(DLLIST_RCU_NONE_);
+
+    rcu->retired[rcu->retired_cnt].slot  = slot;
+    rcu->retired[rcu->retired_cnt].epoch = __atomic_fetch_add(&rcu->epoch, 1, __ATOMIC_SEQ_CST);
+    ++rcu->retired_cnt;
+
+    if(rcu->retired_cnt >= DLLIST_RCU_RECLAIM_BATCH)
+        dllist_rcu_reclaim(rcu);
+}
+
+// Oldest epoch a reader is still inside, or the current one when none is
+static ssize_t dllist_rcu_min_epoch_(dllist_rcu_t* rcu)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    ssize_t min = __atomic_load_n(&rcu->epoch, __ATOMIC_SEQ_CST);
+
+    for(ssize_t i = 0; i < DLLIST_RCU_READERS; ++i) {
+        ssize_t epoch = __atomic_load_n(&rcu->reader[i].epoch, __ATOMIC_SEQ_CST);
+
+        if(epoch != 0 && epoch < min)
+            min = epoch;
+    }
+
+    return min;
+}
+
+// Anything retired before the oldest epoch a reader is in is unreachable
+void dllist_rcu_reclaim(dllist_rcu_t* rcu)
+{
+    utils_assert(rcu);
+
+    ssize_t safe = dllist_rcu_min_epoch_(rcu);
+    ssize_t kept = 0;
+
+    for(ssize_t i = 0; i < rcu->retired_cnt; ++i) {
+        if(rcu->retired[i].epoch >= safe) {
+            rcu->retired[kept++] = rcu->retired[i];
+            continue;
+        }
+
+        ssize_t slot = rcu->retired[i].slot;
+
+        DLLIST_RCU_PUBLISH_(rcu->buf->next[slot], rcu->free);
+        rcu->free = slot;
+    }
+
+    rcu->retired_cnt = kept;
+
+    kept = 0;
+
+    for(ssize_t i = 0; i < rcu->old_cnt; ++i) {
+        if(rcu->old_epoch[i] >= safe) {
+            rcu->old_buf[kept]   = rcu->old_buf[i];
+            rcu->old_epoch[kept] = rcu->old_epoch[i];
+            ++kept;
+            continue;
+        }
+
+        NFREE(rcu->old_buf[i]);
+    }
+
+    rcu->old_cnt = kept;
+}
+
+ssize_t dllist_rcu_reader_register(dllist_rcu_t* rcu)
+{
+    utils_assert(rcu);
+
+    for(ssize_t i = 0; i < DLLIST_RCU_READERS; ++i) {
+        int unused = 0;
+
+        if(__atomic_compare_exchange_n(&rcu->reader[i].used, &unused, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            return i;
+    }
+
+    return DLLIST_RCU_NONE_;
+}
+
+void dllist_rcu_reader_unregister(dllist_rcu_t* rcu, ssize_t reader)
+{
+    utils_assert(rcu);
+    utils_assert(reader >= 0 && reader < DLLIST_RCU_READERS);
+
+    __atomic_store_n(&rcu->reader[reader].epoch, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&rcu->reader[reader].used, 0, __ATOMIC_RELEASE);
+}
+
+// The epoch is announced before the buffer is loaded, so the writer
+// either sees the reader or the reader sees the writer's unlinks
+const dllist_rcu_buf_t* dllist_rcu_read_lock(dllist_rcu_t* rcu, ssize_t reader)
+{
+    utils_assert(rcu);
+    utils_assert(reader >= 0 && reader < DLLIST_RCU_READERS);
+
+    ssize_t epoch = __atomic_load_n(&rcu->epoch, __ATOMIC_SEQ_CST);
+
+    __atomic_store_n(&rcu->reader[reader].epoch, epoch, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return __atomic_load_n(&rcu->buf, __ATOMIC_ACQUIRE);
+}
+
+void dllist_rcu_read_unlock(dllist_rcu_t* rcu, ssize_t reader)
+{
+    utils_assert(rcu);
+    utils_assert(reader >= 0 && reader < DLLIST_RCU_READERS);
+
+    __atomic_store_n(&rcu->reader[reader].epoch, 0, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,345 @@
+#include "dllist_unrolled.h"
+
+#include <memory.h>
+#include <stdlib.h>
+
+#include "memutils.h"
+#include "assertutils.h"
+
+#ifdef _DEBUG
+
+#define DLLIST_UNROLLED_ASSERT_OK_(ulist) dllist_unrolled_assert_ok_(ulist)
+
+#else // _DEBUG
+
+#define DLLIST_UNROLLED_ASSERT_OK_(ulist)
+
+#endif // _DEBUG
+
+static const ssize_t DLLIST_UNROLLED_NULL_ = 0;
+
+static_assert(DLLIST_UNROLLED_BLOCK >= 2, "a full block is split into two halves");
+
+static dllist_err_t dllist_unrolled_fit_(dllist_unrolled_t* ulist);
+
+static dllist_err_t dllist_unrolled_new_block_(dllist_unrolled_t* ulist, ssize_t after, ssize_t* blk);
+
+static void dllist_unrolled_absorb_(dllist_unrolled_t* ulist, ssize_t blk, ssize_t nxt);
+
+#ifdef _DEBUG
+
+static void dllist_unrolled_assert_ok_(dllist_unrolled_t* ulist);
+
+#endif // _DEBUG
+
+
+dllist_err_t dllist_unrolled_ctor(dllist_unrolled_t* ulist, ssize_t init_cpcty, char* log_filename)
+{
+    utils_assert(ulist);
+    utils_assert(init_cpcty > 0);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    err = dllist_ctor(&ulist->blocks, init_cpcty / DLLIST_UNROLLED_BLOCK + 1, log_filename);
+    if(err != DLLIST_NONE)
+        return err;
+
+    ulist->vals   = NULL;
+    ulist->vcpcty = 0;
+    ulist->size   = 0;
+
+    return dllist_unrolled_fit_(ulist);
+}
+
+void dllist_unrolled_dtor(dllist_unrolled_t* ulist)
+{
+    utils_assert(ulist);
+
+    dllist_dtor(&ulist->blocks);
+
+    NFREE(ulist->vals);
+
+    ulist->vcpcty = 0;
+    ulist->size   = 0;
+}
+
+// Values follow the block list capacity, which grows on its own
+static dllist_err_t dllist_unrolled_fit_(dllist_unrolled_t* ulist)
+{
+    if(ulist->vcpcty >= ulist->blocks.cpcty)
+        return DLLIST_NONE;
+
+    void* tmp = realloc(
+        ulist->vals,
+        (size_t) ulist->blocks.cpcty * DLLIST_UNROLLED_BLOCK * sizeof(dllist_data_t)
+    );
+
+    if(!tmp)
+        return DLLIST_ALLOC_FAIL;
+
+    ulist->vals   = (dllist_data_t*) tmp;
+    ulist->vcpcty = ulist->blocks.cpcty;
+
+    return DLLIST_NONE;
+}
+
+static dllist_err_t dllist_unrolled_new_block_(dllist_unrolled_t* ulist, ssize_t after, ssize_t* blk)
+{
+    dllist_err_t err = DLLIST_NONE;
+
+    err = dllist_insert_after(&ulist->blocks, 0, after);
+    if(err != DLLIST_NONE)
+        return err;
+
+    *blk = DLLIST_NEXT(&ulist->blocks, after);
+
+    err = dllist_unrolled_fit_(ulist);
+
+    if(err != DLLIST_NONE)
+        dllist_delete_at(&ulist->blocks, *blk);
+
+    return err;
+}
+
+// Moves the values of nxt to the end of blk and drops nxt
+static void dllist_unrolled_absorb_(dllist_unrolled_t* ulist, ssize_t blk, ssize_t nxt)
+{
+    memcpy(
+        DLLIST_UNROLLED_VALS(ulist, blk) + DLLIST_UNROLLED_FILL(ulist, blk),
+        DLLIST_UNROLLED_VALS(ulist, nxt),
+        sizeof(dllist_data_t) * (size_t) DLLIST_UNROLLED_FILL(ulist, nxt)
+    );
+
+    DLLIST_UNROLLED_FILL(ulist, blk) += DLLIST_UNROLLED_FILL(ulist, nxt);
+
+    dllist_delete_at(&ulist->blocks, nxt);
+}
+
+dllist_err_t dllist_unrolled_push_back(dllist_unrolled_t* ulist, dllist_data_t val)
+{
+    ssize_t last = DLLIST_PREV(&ulist->blocks, DLLIST_UNROLLED_NULL_);
+
+    dllist_unrolled_it_t it = {
+        .block = last,
+        .off   = last == DLLIST_UNROLLED_NULL_ ? 0 : DLLIST_UNROLLED_FILL(ulist, last) - 1
+    };
+
+    return dllist_unrolled_insert_after(ulist, &it, val);
+}
+
+// Inserts val behind the element at *it, or in front of the first one
+// when it->block is DLLIST_NULL_, and leaves *it on the new element. A
+// full block is split in halves, except that appending to its end just
+// starts a new block
+dllist_err_t dllist_unrolled_insert_after(dllist_unrolled_t* ulist, dllist_unrolled_it_t* it, dllist_data_t val)
+{
+    DLLIST_UNROLLED_ASSERT_OK_(ulist);
+
+    utils_assert(it);
+
+    dllist_err_t err = DLLIST_NONE;
+
+    ssize_t blk = it->block;
+    ssize_t off = it->off + 1;
+
+    if(blk == DLLIST_UNROLLED_NULL_) {
+        blk = DLLIST_NEXT(&ulist->blocks, DLLIST_UNROLLED_NULL_);
+        off = 0;
+    }
+
+    if(blk == DLLIST_UNROLLED_NULL_) {
+        err = dllist_unrolled_new_block_(ulist, DLLIST_UNROLLED_NULL_, &blk);
+        if(err != DLLIST_NONE)
+            return err;
+    }
+
+    ssize_t fill = DLLIST_UNROLLED_FILL(ulist, blk);
+
+    IF_DEBUG(
+        if(off > fill)
+            return DLLIST_OUT_OF_BOUND;
+    )
+
+    if(fill == DLLIST_UNROLLED_BLOCK) {
+        ssize_t nw = DLLIST_UNROLLED_NULL_;
+
+        err = dllist_unrolled_new_block_(ulist, blk, &nw);
+        if(err != DLLIST_NONE)
+            return err;
+
+        if(off == DLLIST_UNROLLED_BLOCK) {
+            blk  = nw;
+            off  = 0;
+            fill = 0;
+        }
+        else {
+            const ssize_t half = DLLIST_UNROLLED_BLOCK / 2;
+
+            memcpy(
+                DLLIST_UNROLLED_VALS(ulist, nw),
+                DLLIST_UNROLLED_VALS(ulist, blk) + half,
+                sizeof(dllist_data_t) * (DLLIST_UNROLLED_BLOCK - half)
+            );
+
+            DLLIST_UNROLLED_FILL(ulist, nw)  = DLLIST_UNROLLED_BLOCK - half;
+            DLLIST_UNROLLED_FILL(ulist, blk) = half;
+
+            if(off > half) {
+                blk  = nw;
+                off -= half;
+            }
+
+            fill = DLLIST_UNROLLED_FILL(ulist, blk);
+        }
+    }
+
+    dllist_data_t* vals = DLLIST_UNROLLED_VALS(ulist, blk);
+
+    memmove(vals + off + 1, vals + off, sizeof(dllist_data_t) * (size_t) (fill - off));
+
+    vals[off] = val;
+
+    DLLIST_UNROLLED_FILL(ulist, blk) = (dllist_data_t) (fill + 1);
+
+    ++ulist->size;
+
+    it->block = blk;
+    it->off   = off;
+
+    return DLLIST_NONE;
+}
+
+// Removes the element at *it and leaves *it on the one that followed. A
+// block that drops to half a block together with a neighbour is merged
+// into it, an emptied block is dropped
+dllist_err_t dllist_unrolled_delete_at(dllist_unrolled_t* ulist, dllist_unrolled_it_t* it)
+{
+    DLLIST_UNROLLED_ASSERT_OK_(ulist);
+
+    utils_assert(it);
+
+    ssize_t blk = it->block;
+    ssize_t off = it->off;
+
+    IF_DEBUG(
+        if(blk <= DLLIST_UNROLLED_NULL_ || blk >= ulist->blocks.hwm)
+            return DLLIST_OUT_OF_BOUND;
+
+        if(off < 0 || off >= DLLIST_UNROLLED_FILL(ulist, blk))
+            return DLLIST_OUT_OF_BOUND;
+    )
+
+    ssize_t        fill = DLLIST_UNROLLED_FILL(ulist, blk);
+    dllist_data_t* vals = DLLIST_UNROLLED_VALS(ulist, blk);
+
+    memmove(vals + off, vals + off + 1, sizeof(dllist_data_t) * (size_t) (fill - off - 1));
+
+    DLLIST_UNROLLED_FILL(ulist, blk) = (dllist_data_t) --fill;
+
+    --ulist->size;
+
+    ssize_t nxt = DLLIST_NEXT(&ulist->blocks, blk);
+    ssize_t prv = DLLIST_PREV(&ulist->blocks, blk);
+
+    if(fill == 0) {
+        dllist_delete_at(&ulist->blocks, blk);
+
+        it->block = nxt;
+        it->off   = 0;
+
+        return DLLIST_NONE;
+    }
+
+    if(nxt != DLLIST_UNROLLED_NULL_
+       && fill + DLLIST_UNROLLED_FILL(ulist, nxt) <= DLLIST_UNROLLED_BLOCK / 2)
+        dllist_unrolled_absorb_(ulist, blk, nxt);
+
+    if(prv != DLLIST_UNROLLED_NULL_
+       && DLLIST_UNROLLED_FILL(ulist, prv) + DLLIST_UNROLLED_FILL(ulist, blk) <= DLLIST_UNROLLED_BLOCK / 2) {
+        off += DLLIST_UNROLLED_FILL(ulist, prv);
+
+        dllist_unrolled_absorb_(ulist, prv, blk);
+
+        blk = prv;
+    }
+
+    if(off < DLLIST_UNROLLED_FILL(ulist, blk)) {
+        it->block = blk;
+        it->off   = off;
+    }
+    else {
+        it->block = DLLIST_NEXT(&ulist->blocks, blk);
+        it->off   = 0;
+    }
+
+    return DLLIST_NONE;
+}
+
+dllist_unrolled_it_t dllist_unrolled_begin(dllist_unrolled_t* ulist)
+{
+    dllist_unrolled_it_t it = {
+        .block = DLLIST_NEXT(&ulist->blocks, DLLIST_UNROLLED_NULL_),
+        .off   = 0
+    };
+
+    return it;
+}
+
+dllist_unrolled_it_t dllist_unrolled_next(dllist_unrolled_t* ulist, dllist_unrolled_it_t it)
+{
+    if(it.off + 1 < DLLIST_UNROLLED_FILL(ulist, it.block)) {
+        ++it.off;
+        return it;
+    }
+
+    it.block = DLLIST_NEXT(&ulist->blocks, it.block);
+    it.off   = 0;
+
+    return it;
+}
+
+// Positions are 1-based, the walk skips whole blocks by their fill
+dllist_unrolled_it_t dllist_unrolled_at(dllist_unrolled_t* ulist, ssize_t pos)
+{
+    DLLIST_UNROLLED_ASSERT_OK_(ulist);
+
+    dllist_unrolled_it_t it = {
+        .block = DLLIST_UNROLLED_NULL_,
+        .off   = 0
+    };
+
+    DLLIST_UNROLLED_FOR_EACH_BLOCK(ulist, blk) {
+        if(pos <= DLLIST_UNROLLED_FILL(ulist, blk)) {
+            it.block = blk;
+            it.off   = pos - 1;
+            break;
+        }
+
+        pos -= DLLIST_UNROLLED_FILL(ulist, blk);
+    }
+
+    return it;
+}
+
+
+#ifdef _DEBUG
+
+static void dllist_unrolled_assert_ok_(dllist_unrolled_t* ulist)
+{
+    utils_assert(ulist);
+    utils_assert(ulist->vals);
+    utils_assert(ulist->vcpcty >= ulist->blocks.cpcty);
+
+    ssize_t size = 0;
+
+    DLLIST_UNROLLED_FOR_EACH_BLOCK(ulist, blk) {
+        utils_assert(DLLIST_UNROLLED_FILL(ulist, blk) > 0);
+        utils_assert(DLLIST_UNROLLED_FILL(ulist, blk) <= DLLIST_UNROLLED_BLOCK);
+
+        size += DLLIST_UNROLLED_FILL(ulist, blk);
+    }
+
+    utils_assert(size == ulist->size);
+}
+
+#endif // _DEBUG
@@ -0,0 +1,86 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "dllist_alloc.h"
+#include "utils.h"
+
+static double seconds_since(const timespec* start)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    dllist_arena_t arena = {};
+
+    const int LIST_SIZE = 20000000;
+    const int SEED = 31415;
+
+    const char* NAMES[] = {"heap", "huge pages", "arena", "numa node 0"};
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        long sums[4] = {};
+
+        // the list is built at its final capacity, so the arena holds a 
+        // single block; three links a node cover both layouts
+        DLLIST_VERIFY(dllist_arena_ctor(&arena, (size_t) (LIST_SIZE + 1) * 3 * sizeof(dllist_idx_t)));
+
+        for(int k = 0; k < 4; ++k) {
+            dllist_alloc_t alloc = {};
+
+            if(k == 1)
+                dllist_alloc_huge(&alloc);
+            else if(k == 2)
+                dllist_alloc_arena(&alloc, &arena);
+            else if(k == 3)
+                dllist_alloc_numa(&alloc, 0);
+
+            dllist_config_t config = {};
+
+            config.init_cpcty   = LIST_SIZE + 1;
+            config.log_filename = "";
+            config.alloc        = k ? &alloc : NULL;
+
+            DLLIST_VERIFY(dllist_ctor_ex(&list, &config));
+
+            srand(SEED);
+
+            for(int i = 0; i < LIST_SIZE; ++i)
+                DLLIST_VERIFY(dllist_insert_after(&list, rand(), i ? rand() % i + 1 : 0));
+
+            // every step of the walk lands on a random page
+            timespec start = {};
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            DLLIST_FOR_EACH(&list, i)
+                sums[k] += DLLIST_DATA(&list, i);
+
+            printf("%-12s walk %.3f s\n", NAMES[k], seconds_since(&start));
+
+            dllist_dtor(&list);
+        }
+
+        dllist_arena_dtor(&arena);
+
+        if(sums[1] != sums[0] || sums[2] != sums[0] || sums[3] != sums[0])
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    dllist_arena_dtor(&arena);
+    return EXIT_FAILURE;
+}
@@ -22,7 +22,7 @@ int main(int argc, char* argv[])
         DLLIST_VERIFY(dllist_insert_after(&list, 10, 1));
         DLLIST_VERIFY(dllist_insert_after(&list, 10, 2));
 
-        list.next[2] = 1000;
+        DLLIST_NEXT(&list, 2) = 1000;
 
         DLLIST_VERIFY(dllist_insert_after(&list, 10, 3));
 
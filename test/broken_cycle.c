@@ -23,7 +23,7 @@ int main(int argc, char* argv[])
         DLLIST_VERIFY(dllist_insert_after(&list, 10, 0));
         DLLIST_VERIFY(dllist_insert_after(&list, 10, 0));
 
-        list.next[2] = 1000;
+        DLLIST_NEXT(&list, 2) = 1000;
 
         DLLIST_VERIFY(dllist_insert_after(&list, 10, 0));
 
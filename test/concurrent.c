@@ -0,0 +1,109 @@
+#include <cstdlib>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist_concurrent.h"
+#include "utils.h"
+
+static const int OP_CNT = 8000000;
+static const int OWN_MAX = 1024;
+
+typedef struct worker_t
+{
+    dllist_concurrent_t* list;
+
+    int op_cnt;
+    unsigned seed;
+
+    dllist_err_t err;
+
+} worker_t;
+
+// Every thread edits around its own nodes: it inserts after a random
+// one of them or deletes one, keeping at most OWN_MAX
+static void* worker(void* arg)
+{
+    worker_t* wrk = (worker_t*) arg;
+
+    dllist_concurrent_ctx_t ctx;
+    dllist_concurrent_ctx_init(&ctx);
+
+    ssize_t* own = (ssize_t*) calloc(OWN_MAX, sizeof(ssize_t));
+    int own_cnt = 0;
+
+    for(int i = 0; i < wrk->op_cnt && wrk->err == DLLIST_NONE; ++i) {
+        int pick = own_cnt ? rand_r(&wrk->seed) % own_cnt : 0;
+
+        if(own_cnt < OWN_MAX && (own_cnt < 2 || rand_r(&wrk->seed) % 2)) {
+            ssize_t after = own_cnt ? own[pick] : 0;
+
+            wrk->err = dllist_concurrent_insert_after(wrk->list, &ctx, i, after, &own[own_cnt]);
+            ++own_cnt;
+        }
+        else {
+            wrk->err = dllist_concurrent_delete_at(wrk->list, &ctx, own[pick]);
+            own[pick] = own[--own_cnt];
+        }
+    }
+
+    dllist_concurrent_ctx_flush(wrk->list, &ctx);
+
+    free(own);
+
+    return NULL;
+}
+
+int main()
+{
+    const int THREAD_CNTS[] = {1, 2, 4, 8};
+    const int LIST_INIT_SIZE = 10000;
+    const unsigned SEED = 31415;
+
+    for(size_t t = 0; t < sizeof(THREAD_CNTS) / sizeof(THREAD_CNTS[0]); ++t) {
+        int thread_cnt = THREAD_CNTS[t];
+
+        // stripes are cache-line aligned
+        dllist_concurrent_t* list = (dllist_concurrent_t*) aligned_alloc(alignof(dllist_concurrent_t), sizeof(dllist_concurrent_t));
+
+        if(!list)
+            return EXIT_FAILURE;
+
+        if(dllist_concurrent_ctor(list, LIST_INIT_SIZE, "") != DLLIST_NONE) {
+            free(list);
+            return EXIT_FAILURE;
+        }
+
+        pthread_t thread[8];
+        worker_t  wrk[8];
+
+        timespec start = {}, stop = {};
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(int i = 0; i < thread_cnt; ++i) {
+            wrk[i] = {list, OP_CNT / thread_cnt, SEED + (unsigned) i, DLLIST_NONE};
+            pthread_create(&thread[i], NULL, worker, &wrk[i]);
+        }
+
+        int failed = 0;
+
+        for(int i = 0; i < thread_cnt; ++i) {
+            pthread_join(thread[i], NULL);
+            failed |= wrk[i].err != DLLIST_NONE;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        double sec = (double) (stop.tv_sec - start.tv_sec) + (double) (stop.tv_nsec - start.tv_nsec) * 1e-9;
+
+        printf("threads: %d, size: %ld, ops/s: %.0f\n", thread_cnt, dllist_concurrent_size(list), OP_CNT / sec);
+
+        dllist_concurrent_dtor(list);
+        free(list);
+
+        if(failed)
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+static int is_odd(dllist_data_t val, void* ctx)
+{
+    (void) ctx;
+
+    return val % 2;
+}
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int ELEMENT_CNT = 50000000;
+    const int ERASE_CNT = 5000000;
+    const int LIST_INIT_SIZE = 10000;
+    
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        DLLIST_VERIFY(dllist_ctor(&list, LIST_INIT_SIZE, ""));
+
+        for(int i = 0; i < ELEMENT_CNT; ++i)
+            dllist_insert_after(&list, i, 0);
+
+        ssize_t first = dllist_at(&list, ELEMENT_CNT / 2);
+        ssize_t last  = dllist_at(&list, ELEMENT_CNT / 2 + ERASE_CNT - 1);
+
+        DLLIST_VERIFY(dllist_erase_range(&list, first, last));
+
+        DLLIST_VERIFY(dllist_remove_if(&list, is_odd, NULL));
+
+        dllist_dtor(&list);
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    return EXIT_FAILURE;
+}
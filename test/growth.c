@@ -0,0 +1,73 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+static double seconds_since(const timespec* start)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int LIST_SIZE = 20000000;
+    const int SEED = 31415;
+
+    const char* NAMES[] = {"x2", "x1.25", "+1M", "reserve"};
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        for(int k = 0; k < 4; ++k) {
+            dllist_config_t config = {};
+
+            config.log_filename = "";
+
+            if(k == 1)
+                config.growth.factor = 1.25;
+            else if(k == 2)
+                config.growth.step = 1000000;
+
+            DLLIST_VERIFY(dllist_ctor_ex(&list, &config));
+
+            srand(SEED);
+
+            timespec start = {};
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            // the size is known up front, so not one realloc is needed
+            if(k == 3)
+                DLLIST_VERIFY(dllist_reserve(&list, LIST_SIZE));
+
+            int grows = 0;
+
+            for(int i = 0; i < LIST_SIZE; ++i) {
+                ssize_t cpcty = list.cpcty;
+
+                DLLIST_VERIFY(dllist_insert_after(&list, rand(), i ? rand() % i + 1 : 0));
+
+                grows += list.cpcty != cpcty;
+            }
+
+            printf("%-8s insert %.3f s, %d reallocs, unused slots %.1f%%\n", NAMES[k], seconds_since(&start), grows,
+                   100.0 * (double) (list.cpcty - list.hwm) / (double) list.cpcty);
+
+            dllist_dtor(&list);
+        }
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    return EXIT_FAILURE;
+}
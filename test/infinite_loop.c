@@ -23,7 +23,7 @@ int main(int argc, char* argv[])
         DLLIST_VERIFY(dllist_insert_after(&list, 20, 1));
         DLLIST_VERIFY(dllist_insert_after(&list, 30, 2));
 
-        list.next[3] = 1;
+        DLLIST_NEXT(&list, 3) = 1;
 
         DLLIST_VERIFY(dllist_insert_after(&list, 30, 2));
 
@@ -0,0 +1,48 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int ELEMENT_CNT = 5000000;
+    const int LIST_INIT_SIZE = 10000;
+    const int AT_CNT = 5000000;
+    const int SEED = 31415;
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        DLLIST_VERIFY(dllist_ctor(&list, LIST_INIT_SIZE, ""));
+        DLLIST_VERIFY(dllist_order_enable(&list));
+
+        srand(SEED);
+
+        for(int i = 0; i < ELEMENT_CNT; ++i)
+            DLLIST_VERIFY(dllist_insert_at_pos(&list, rand() % (list.size + 1) + 1, i));
+
+        long long sum = 0;
+
+        for(int i = 0; i < AT_CNT; ++i) {
+            ssize_t slot = dllist_at(&list, rand() % ELEMENT_CNT + 1);
+
+            sum += DLLIST_DATA(&list, slot) + dllist_pos_of(&list, slot);
+        }
+
+        printf("%lld\n", sum);
+
+        dllist_dtor(&list);
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    return EXIT_FAILURE;
+}
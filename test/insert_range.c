@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int LIST_SIZE = 50000000;
+    const int CHUNK_SIZE = 10000;
+    
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    dllist_data_t* vals = (dllist_data_t*)calloc(LIST_SIZE, sizeof(vals[0]));
+
+    BEGIN {
+        if(!vals)
+            GOTO_END;
+
+        for(int i = 0; i < LIST_SIZE; ++i)
+            vals[i] = i;
+
+        DLLIST_VERIFY(dllist_from_array(&list, vals, LIST_SIZE / 2, ""));
+
+        for(int i = LIST_SIZE / 2; i < LIST_SIZE; i += CHUNK_SIZE)
+            DLLIST_VERIFY(dllist_insert_range_after(&list, vals + i, CHUNK_SIZE, 0));
+
+        dllist_dtor(&list);
+        free(vals);
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    free(vals);
+    return EXIT_FAILURE;
+}
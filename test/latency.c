@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+static double seconds_since(const timespec* start)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int LIST_SIZE = 20000000;
+    const int SEED = 31415;
+
+    const char* NAMES[] = {"realloc", "max_cpcty"};
+
+    double* lat = (double*) calloc(LIST_SIZE, sizeof(double));
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        if(!lat)
+            GOTO_END;
+
+        for(int k = 0; k < 2; ++k) {
+            dllist_config_t config = {};
+
+            config.log_filename = "";
+            config.max_cpcty    = k ? LIST_SIZE + 1 : 0;
+
+            DLLIST_VERIFY(dllist_ctor_ex(&list, &config));
+
+            srand(SEED);
+
+            // every insert timed on its own, the ones that grow the list
+            // are the tail
+            for(int i = 0; i < LIST_SIZE; ++i) {
+                int val   = rand();
+                int after = i ? rand() % i + 1 : 0;
+
+                timespec start = {};
+                clock_gettime(CLOCK_MONOTONIC, &start);
+
+                DLLIST_VERIFY(dllist_insert_after(&list, val, after));
+
+                lat[i] = seconds_since(&start);
+            }
+
+            std::sort(lat, lat + LIST_SIZE);
+
+            printf("%-10s p50 %.3f us, p99.9 %.3f us, max %.3f ms\n", NAMES[k],
+                   lat[LIST_SIZE / 2] * 1e6, lat[LIST_SIZE - LIST_SIZE / 1000] * 1e6, lat[LIST_SIZE - 1] * 1e3);
+
+            dllist_dtor(&list);
+        }
+
+        free(lat);
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    free(lat);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,80 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "dllist_pool.h"
+#include "utils.h"
+
+static double seconds_since(const timespec* start)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+int main()
+{
+
+    DLLIST_MAKE(serial);
+    DLLIST_MAKE(parallel);
+
+    dllist_pool_t pool = {};
+
+    const int LIST_SIZE = 20000000;
+    const int LIST_INIT_SIZE = 10000;
+    const int SEED = 31415;
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        DLLIST_VERIFY(dllist_ctor(&serial, LIST_INIT_SIZE, ""));
+        DLLIST_VERIFY(dllist_ctor(&parallel, LIST_INIT_SIZE, ""));
+        DLLIST_VERIFY(dllist_pool_ctor(&pool, 0));
+
+        // every element goes after a random earlier one, so list order
+        // and slot order are unrelated
+        srand(SEED);
+
+        for(int i = 0; i < LIST_SIZE; ++i) {
+            ssize_t after = i ? rand() % i + 1 : 0;
+
+            DLLIST_VERIFY(dllist_insert_after(&serial, i, after));
+            DLLIST_VERIFY(dllist_insert_after(&parallel, i, after));
+        }
+
+        timespec start = {};
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        DLLIST_VERIFY(dllist_linearize(&serial));
+        printf("serial:   %.3f s\n", seconds_since(&start));
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        DLLIST_VERIFY(dllist_linearize_parallel(&parallel, &pool));
+        printf("parallel: %.3f s, %d threads\n", seconds_since(&start), pool.nthreads);
+
+        ssize_t diff = 0;
+
+        for(ssize_t i = 1; i <= LIST_SIZE; ++i)
+            diff += DLLIST_DATA(&serial, i) != DLLIST_DATA(&parallel, i);
+
+        if(diff)
+            GOTO_END;
+
+        dllist_pool_dtor(&pool);
+        dllist_dtor(&parallel);
+        dllist_dtor(&serial);
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    if(pool.thread)
+        dllist_pool_dtor(&pool);
+
+    dllist_dtor(&parallel);
+    dllist_dtor(&serial);
+    return EXIT_FAILURE;
+}
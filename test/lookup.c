@@ -0,0 +1,49 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int ELEMENT_CNT = 5000000;
+    const int LOOKUP_CNT = 500000;
+    const int LIST_INIT_SIZE = 10000;
+    const int SEED = 31415;
+    
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        DLLIST_VERIFY(dllist_ctor(&list, LIST_INIT_SIZE, ""));
+        DLLIST_VERIFY(dllist_hash_enable(&list));
+
+        srand(SEED);
+
+        for(int i = 0; i < ELEMENT_CNT; ++i)
+            dllist_insert_after(&list, i, rand() % (list.size + 1));
+
+        ssize_t found_cnt = 0;
+
+        for(ssize_t i = 0; i < LOOKUP_CNT; ++i) {
+            int to_lookup = rand() % ELEMENT_CNT;
+
+            if(dllist_lookup(&list, to_lookup) != 0)
+                found_cnt++;
+        }
+
+        printf("%ld\n", found_cnt);
+
+        dllist_dtor(&list);
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,89 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+static double seconds_since(const timespec* start)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+static long sum_of(dllist_t* list)
+{
+    long sum = 0;
+
+    DLLIST_FOR_EACH(list, i)
+        sum += DLLIST_DATA(list, i);
+
+    return sum;
+}
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int LIST_SIZE = 20000000;
+    const int LIST_INIT_SIZE = 10000;
+    const int SEED = 31415;
+
+    const char* PATH = "mapped.bin";
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        unlink(PATH);
+
+        DLLIST_VERIFY(dllist_ctor_file(&list, PATH, LIST_INIT_SIZE, ""));
+
+        srand(SEED);
+
+        timespec start = {};
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        // grows the file by doubling, like the heap block would
+        for(int i = 0; i < LIST_SIZE; ++i)
+            DLLIST_VERIFY(dllist_insert_after(&list, rand(), i ? rand() % i + 1 : 0));
+
+        printf("insert: %.3f s, cpcty %ld\n", seconds_since(&start), list.cpcty);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        DLLIST_VERIFY(dllist_linearize(&list));
+        printf("linearize: %.3f s\n", seconds_since(&start));
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        DLLIST_VERIFY(dllist_sync(&list, 1));
+        printf("sync: %.3f s\n", seconds_since(&start));
+
+        long sum = sum_of(&list);
+
+        dllist_dtor(&list);
+
+        // reopening maps the file as it was left
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        DLLIST_VERIFY(dllist_ctor_file(&list, PATH, LIST_INIT_SIZE, ""));
+        printf("reopen: %.6f s\n", seconds_since(&start));
+
+        int same = list.size == LIST_SIZE && sum == sum_of(&list);
+
+        dllist_dtor(&list);
+        unlink(PATH);
+
+        if(!same)
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    unlink(PATH);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,91 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+static double seconds_since(const timespec* start)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int LIST_SIZE = 2000000;
+    const int CHURN = 8000000;
+    const int WALKS = 10;
+    const int SEED = 31415;
+
+    const char* NAMES[] = {"free list", "near"};
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        int counted = 1;
+
+        for(int near = 0; near < 2; ++near) {
+            DLLIST_VERIFY(dllist_ctor(&list, LIST_SIZE + 1, ""));
+
+            if(near)
+                DLLIST_VERIFY(dllist_near_enable(&list));
+
+            for(int i = 0; i < LIST_SIZE; ++i)
+                DLLIST_VERIFY(dllist_insert_after(&list, i, i));
+
+            // a quarter of the slots are left free for the inserts to pick
+            for(int i = 4; i <= LIST_SIZE; i += 4)
+                DLLIST_VERIFY(dllist_delete_at(&list, i));
+
+            // a random element moves next to another random one; from the 
+            // free list each insert gets the slot of an unrelated delete
+            srand(SEED);
+
+            for(int i = 0; i < CHURN; ++i) {
+                ssize_t at    = rand() % LIST_SIZE + 1;
+                ssize_t after = rand() % LIST_SIZE + 1;
+
+                if(at == after || DLLIST_PREV(&list, at) == -1 || DLLIST_PREV(&list, after) == -1)
+                    continue;
+
+                DLLIST_VERIFY(dllist_delete_at(&list, at));
+                DLLIST_VERIFY(dllist_insert_after(&list, i, after));
+            }
+
+            timespec start = {};
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            long sum = 0;
+            long cnt = 0;
+
+            for(int w = 0; w < WALKS; ++w) {
+                DLLIST_FOR_EACH(&list, i) {
+                    sum += DLLIST_DATA(&list, i);
+                    ++cnt;
+                }
+            }
+
+            printf("%-10s walk %.3f s, sum %ld\n", NAMES[near], seconds_since(&start) / WALKS, sum);
+
+            counted &= cnt == (long) WALKS * list.size;
+
+            dllist_dtor(&list);
+        }
+
+        if(!counted)
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,49 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int LIST_SIZE = 50000000;
+    const int LIST_INIT_SIZE = 10000;
+    const int READ_CNT = 10;
+    const int AT_CNT = 5000000;
+    const int SEED = 31415;
+    
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        DLLIST_VERIFY(dllist_ctor(&list, LIST_INIT_SIZE, ""));
+
+        for(size_t i = 0; i < LIST_SIZE; ++i)
+            dllist_insert_after(&list, (int)i, dllist_end(&list));
+
+        long long sum = 0;
+
+        for(int i = 0; i < READ_CNT; ++i)
+            DLLIST_FOR_EACH(&list, j)
+                sum += DLLIST_DATA(&list, j);
+
+        srand(SEED);
+
+        for(int i = 0; i < AT_CNT; ++i)
+            sum += DLLIST_DATA(&list, dllist_at(&list, rand() % LIST_SIZE + 1));
+
+        printf("%lld\n", sum);
+
+        dllist_dtor(&list);
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    return EXIT_FAILURE;
+}
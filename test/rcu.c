@@ -0,0 +1,131 @@
+#include <cstdlib>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist_rcu.h"
+#include "utils.h"
+
+static const int WRITE_CNT = 4000000;
+static const int LIST_SIZE = 10000;
+
+typedef struct reader_t
+{
+    dllist_rcu_t* rcu;
+
+    int* stop;
+    long walks;
+    long sum;
+
+} reader_t;
+
+// Walks the whole list over and over until the writer is done
+static void* reader(void* arg)
+{
+    reader_t* rdr = (reader_t*) arg;
+
+    ssize_t id = dllist_rcu_reader_register(rdr->rcu);
+
+    if(id < 0)
+        return NULL;
+
+    while(!__atomic_load_n(rdr->stop, __ATOMIC_ACQUIRE)) {
+        const dllist_rcu_buf_t* buf = dllist_rcu_read_lock(rdr->rcu, id);
+
+        for(ssize_t cur = DLLIST_RCU_NEXT(buf, 0); cur != 0; cur = DLLIST_RCU_NEXT(buf, cur))
+            rdr->sum += DLLIST_RCU_DATA(buf, cur);
+
+        dllist_rcu_read_unlock(rdr->rcu, id);
+
+        ++rdr->walks;
+    }
+
+    dllist_rcu_reader_unregister(rdr->rcu, id);
+
+    return NULL;
+}
+
+// The writer keeps the size around LIST_SIZE, inserting after the head
+// and deleting the slot it inserted LIST_SIZE operations ago
+static dllist_err_t writer(dllist_rcu_t* rcu)
+{
+    dllist_err_t err = DLLIST_NONE;
+
+    ssize_t* ring = (ssize_t*) calloc(LIST_SIZE, sizeof(ssize_t));
+
+    if(!ring)
+        return DLLIST_ALLOC_FAIL;
+
+    for(int i = 0; i < LIST_SIZE && err == DLLIST_NONE; ++i)
+        err = dllist_rcu_insert_after(rcu, i, 0, &ring[i]);
+
+    for(int i = 0; i < WRITE_CNT && err == DLLIST_NONE; ++i) {
+        ssize_t* old = &ring[i % LIST_SIZE];
+
+        err = dllist_rcu_delete_at(rcu, *old);
+
+        if(err == DLLIST_NONE)
+            err = dllist_rcu_insert_after(rcu, i, 0, old);
+    }
+
+    free(ring);
+
+    return err;
+}
+
+int main()
+{
+    const int THREAD_CNTS[] = {1, 2, 4, 8};
+
+    for(size_t t = 0; t < sizeof(THREAD_CNTS) / sizeof(THREAD_CNTS[0]); ++t) {
+        int thread_cnt = THREAD_CNTS[t];
+
+        // reader records are cache-line aligned
+        dllist_rcu_t* rcu = (dllist_rcu_t*) aligned_alloc(alignof(dllist_rcu_t), sizeof(dllist_rcu_t));
+
+        if(!rcu)
+            return EXIT_FAILURE;
+
+        if(dllist_rcu_ctor(rcu, 16) != DLLIST_NONE) {
+            free(rcu);
+            return EXIT_FAILURE;
+        }
+
+        pthread_t thread[8];
+        reader_t  rdr[8];
+        int       stop = 0;
+
+        timespec start = {}, end = {};
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(int i = 0; i < thread_cnt; ++i) {
+            rdr[i] = {rcu, &stop, 0, 0};
+            pthread_create(&thread[i], NULL, reader, &rdr[i]);
+        }
+
+        dllist_err_t err = writer(rcu);
+
+        __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+
+        long walks = 0;
+
+        for(int i = 0; i < thread_cnt; ++i) {
+            pthread_join(thread[i], NULL);
+            walks += rdr[i].walks;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double sec = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+        printf("readers: %d, size: %ld, writes/s: %.0f, walks/s: %.0f\n", thread_cnt, rcu->size, WRITE_CNT / sec, (double) walks / sec);
+
+        dllist_rcu_dtor(rcu);
+        free(rcu);
+
+        if(err != DLLIST_NONE)
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
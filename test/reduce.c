@@ -0,0 +1,124 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "dllist_pool.h"
+#include "utils.h"
+
+static double seconds_since(const timespec* start)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+static int64_t add_val(int64_t acc, dllist_data_t val, void* ctx)
+{
+    (void) ctx;
+
+    return acc + val;
+}
+
+static int64_t add(int64_t lhs, int64_t rhs, void* ctx)
+{
+    (void) ctx;
+
+    return lhs + rhs;
+}
+
+static void number(dllist_data_t* val, void* ctx)
+{
+    *val = __atomic_fetch_add((int*) ctx, 1, __ATOMIC_RELAXED);
+}
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    dllist_pool_t pool = {};
+
+    const int LIST_SIZE = 20000000;
+    const int LIST_INIT_SIZE = 10000;
+    const int SEED = 31415;
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        DLLIST_VERIFY(dllist_ctor(&list, LIST_INIT_SIZE, ""));
+        DLLIST_VERIFY(dllist_pool_ctor(&pool, 0));
+
+        // live slots are spread unevenly: every element goes after a
+        // random earlier one and most of the first half is deleted
+        srand(SEED);
+
+        for(int i = 0; i < LIST_SIZE; ++i)
+            DLLIST_VERIFY(dllist_insert_after(&list, i, i ? rand() % i + 1 : 0));
+
+        for(int i = 1; i < LIST_SIZE / 2; ++i)
+            if(i % 8)
+                DLLIST_VERIFY(dllist_delete_at(&list, i));
+
+        timespec start = {};
+        int64_t  serial = 0;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        DLLIST_FOR_EACH(&list, i)
+            serial += DLLIST_DATA(&list, i);
+
+        printf("serial:          %.3f s\n", seconds_since(&start));
+
+        const dllist_walk_t WALKS[] = {DLLIST_WALK_SLOTS, DLLIST_WALK_LIST};
+        const char*         NAMES[] = {"slot order", "list order"};
+
+        int64_t diff = 0;
+
+        for(int w = 0; w < 2; ++w) {
+            int64_t sum = 0;
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            DLLIST_VERIFY(dllist_parallel_reduce(&list, &pool, WALKS[w], 0, add_val, add, NULL, &sum));
+            printf("%-16s %.3f s, %d threads\n", NAMES[w], seconds_since(&start), pool.nthreads);
+
+            diff |= sum - serial;
+        }
+
+        if(diff)
+            GOTO_END;
+
+        dllist_dtor(&list);
+
+        // an indexed list of one value comes out of the walk with as many 
+        // values as elements, more than the index had buckets for
+        const int DUP_CNT = 1000;
+
+        DLLIST_VERIFY(dllist_ctor(&list, LIST_INIT_SIZE, ""));
+        DLLIST_VERIFY(dllist_hash_enable(&list));
+
+        for(int i = 0; i < DUP_CNT; ++i)
+            DLLIST_VERIFY(dllist_insert_after(&list, 7, DLLIST_PREV(&list, 0)));
+
+        int counter = 0;
+
+        DLLIST_VERIFY(dllist_parallel_for_each(&list, &pool, DLLIST_WALK_SLOTS, number, &counter));
+
+        if(dllist_lookup(&list, DUP_CNT - 1) == 0)
+            GOTO_END;
+
+        dllist_pool_dtor(&pool);
+        dllist_dtor(&list);
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    if(pool.thread)
+        dllist_pool_dtor(&pool);
+
+    dllist_dtor(&list);
+    return EXIT_FAILURE;
+}
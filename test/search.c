@@ -29,7 +29,7 @@ int main()
             int to_find = rand() % ELEMENT_CNT;
 
             for(ssize_t j = dllist_begin(&list); j < list.size; j = dllist_next(&list, j)) {
-                if(list.data[j] == to_find)
+                if(DLLIST_DATA(&list, j) == to_find)
                     break;
             }
         }
@@ -0,0 +1,109 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+static double seconds_since(const timespec* start)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int LIST_SIZE = 4000000;
+    const int LIST_INIT_SIZE = 10000;
+    const int STEP = 1024;
+    const int SEED = 31415;
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        DLLIST_VERIFY(dllist_ctor(&list, LIST_INIT_SIZE, ""));
+
+        for(int i = 0; i < LIST_SIZE; ++i)
+            DLLIST_VERIFY(dllist_insert_after(&list, i, i));
+
+        // three quarters of the elements go, scattered over the slots
+        srand(SEED);
+
+        for(int i = 1; i <= LIST_SIZE; ++i)
+            if(rand() % 4)
+                DLLIST_VERIFY(dllist_delete_at(&list, i));
+
+        printf("before:  size %ld, hwm %ld, cpcty %ld\n", list.size, list.hwm, list.cpcty);
+
+        timespec start = {};
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        long steps = 0;
+
+        while(list.compact || list.hwm - 1 > list.size) {
+            DLLIST_VERIFY(dllist_compact(&list, STEP));
+            ++steps;
+        }
+
+        printf("compact: %.3f s in %ld steps of %d, hwm %ld, cpcty %ld\n", seconds_since(&start), steps, STEP, list.hwm, list.cpcty);
+
+        DLLIST_VERIFY(dllist_shrink_to_fit(&list));
+
+        printf("shrunk:  cpcty %ld\n", list.cpcty);
+
+        // moving nodes keeps the list order
+        int ordered = 1;
+        ssize_t prv = 0;
+
+        DLLIST_FOR_EACH(&list, i) {
+            ordered &= prv == 0 || DLLIST_DATA(&list, prv) < DLLIST_DATA(&list, i);
+            prv = i;
+        }
+
+        dllist_dtor(&list);
+
+        // the same deletes with compaction run by them; nodes move, so 
+        // each one is looked up by value rather than held by slot
+        DLLIST_VERIFY(dllist_ctor(&list, LIST_INIT_SIZE, ""));
+        DLLIST_VERIFY(dllist_hash_enable(&list));
+
+        for(int i = 0; i < LIST_SIZE; ++i)
+            DLLIST_VERIFY(dllist_insert_after(&list, i, i));
+
+        dllist_auto_compact(&list, STEP);
+
+        srand(SEED);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(int i = 0; i < LIST_SIZE; ++i)
+            if(rand() % 4)
+                DLLIST_VERIFY(dllist_delete_at(&list, dllist_lookup(&list, i)));
+
+        printf("auto:    %.3f s, size %ld, hwm %ld\n", seconds_since(&start), list.size, list.hwm);
+
+        int compacted = (list.hwm - 1 - list.size) * 4 <= list.hwm - 1;
+        prv = 0;
+
+        DLLIST_FOR_EACH(&list, i) {
+            ordered &= prv == 0 || DLLIST_DATA(&list, prv) < DLLIST_DATA(&list, i);
+            prv = i;
+        }
+
+        dllist_dtor(&list);
+
+        if(!ordered || !compacted)
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+static double seconds_since(const timespec* start)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+static long sum_of(dllist_t* list)
+{
+    long sum = 0;
+
+    DLLIST_FOR_EACH(list, i)
+        sum += DLLIST_DATA(list, i);
+
+    return sum;
+}
+
+int main()
+{
+
+    DLLIST_MAKE(saved);
+    DLLIST_MAKE(loaded);
+
+    const int LIST_SIZE = 20000000;
+    const int LIST_INIT_SIZE = 10000;
+    const int SEED = 31415;
+
+    const char* PATH = "snapshot.bin";
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        DLLIST_VERIFY(dllist_ctor(&saved, LIST_INIT_SIZE, ""));
+
+        srand(SEED);
+
+        for(int i = 0; i < LIST_SIZE; ++i)
+            DLLIST_VERIFY(dllist_insert_after(&saved, rand(), i ? rand() % i + 1 : 0));
+
+        timespec start = {};
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        DLLIST_VERIFY(dllist_save(&saved, PATH));
+        printf("save: %.3f s\n", seconds_since(&start));
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        DLLIST_VERIFY(dllist_load_mmap(&loaded, PATH, ""));
+        printf("load: %.6f s\n", seconds_since(&start));
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        long sum = sum_of(&saved);
+        printf("walk, heap:   %.3f s\n", seconds_since(&start));
+
+        // the first walk pages the snapshot in
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int same = sum == sum_of(&loaded);
+        printf("walk, mapped: %.3f s\n", seconds_since(&start));
+
+        // growing moves the nodes out of the mapping
+        DLLIST_VERIFY(dllist_insert_after(&loaded, 1, 0));
+        DLLIST_VERIFY(dllist_insert_after(&saved, 1, 0));
+
+        same &= sum_of(&saved) == sum_of(&loaded);
+
+        unlink(PATH);
+
+        dllist_dtor(&loaded);
+        dllist_dtor(&saved);
+
+        if(!same)
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    unlink(PATH);
+
+    dllist_dtor(&loaded);
+    dllist_dtor(&saved);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,76 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist.h"
+#include "utils.h"
+
+static double seconds_since(const timespec* start)
+{
+    timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+static int cmp_int(dllist_data_t lhs, dllist_data_t rhs, void* ctx)
+{
+    (void) ctx;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+int main()
+{
+
+    DLLIST_MAKE(list);
+
+    const int LIST_SIZE = 5000000;
+    const int LIST_INIT_SIZE = 10000;
+    const int SEED = 31415;
+
+    const dllist_cmp_t CMPS[]      = {cmp_int, cmp_int, NULL, NULL};
+    const int          LINEARIZE[] = {0, 1, 0, 1};
+    const char*        NAMES[]     = {"merge", "merge, linearized", "radix", "radix, linearized"};
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        int sorted = 1;
+
+        for(size_t k = 0; k < sizeof(CMPS) / sizeof(CMPS[0]); ++k) {
+            DLLIST_VERIFY(dllist_ctor(&list, LIST_INIT_SIZE, ""));
+
+            srand(SEED);
+
+            for(int i = 0; i < LIST_SIZE; ++i)
+                DLLIST_VERIFY(dllist_insert_after(&list, rand() - RAND_MAX / 2, i ? rand() % i + 1 : 0));
+
+            timespec start = {};
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            DLLIST_VERIFY(dllist_sort(&list, CMPS[k], NULL, LINEARIZE[k]));
+
+            printf("%-18s %.3f s\n", NAMES[k], seconds_since(&start));
+
+            ssize_t prv = 0;
+
+            DLLIST_FOR_EACH(&list, i) {
+                sorted &= prv == 0 || DLLIST_DATA(&list, prv) <= DLLIST_DATA(&list, i);
+                prv = i;
+            }
+
+            dllist_dtor(&list);
+        }
+
+        if(!sorted)
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_dtor(&list);
+    return EXIT_FAILURE;
+}
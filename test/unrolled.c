@@ -0,0 +1,56 @@
+#include <cstdlib>
+#include <stdio.h>
+#include <time.h>
+
+#include "dllist_unrolled.h"
+#include "utils.h"
+
+int main()
+{
+
+    DLLIST_UNROLLED_MAKE(list);
+
+    const int LIST_SIZE = 50000000;
+    const int LIST_INIT_SIZE = 10000;
+    const int READ_CNT = 10;
+    const int INSERT_CNT = 1000;
+    const int SEED = 31415;
+
+#define DLLIST_VERIFY(expr) if(expr != DLLIST_NONE) GOTO_END;
+
+    BEGIN {
+        DLLIST_VERIFY(dllist_unrolled_ctor(&list, LIST_INIT_SIZE, ""));
+
+        for(int i = 0; i < LIST_SIZE; ++i)
+            DLLIST_VERIFY(dllist_unrolled_push_back(&list, i));
+
+        srand(SEED);
+
+        for(int i = 0; i < INSERT_CNT; ++i) {
+            dllist_unrolled_it_t it = dllist_unrolled_at(&list, rand() % list.size + 1);
+
+            DLLIST_VERIFY(dllist_unrolled_insert_after(&list, &it, i));
+        }
+
+        long long sum = 0;
+
+        for(int i = 0; i < READ_CNT; ++i)
+            DLLIST_UNROLLED_FOR_EACH_BLOCK(&list, blk) {
+                const dllist_data_t* vals = DLLIST_UNROLLED_VALS(&list, blk);
+
+                for(int j = 0; j < DLLIST_UNROLLED_FILL(&list, blk); ++j)
+                    sum += vals[j];
+            }
+
+        printf("%lld\n", sum);
+
+        dllist_unrolled_dtor(&list);
+
+        return EXIT_SUCCESS;
+    } END;
+
+#undef DLLIST_VERIFY
+
+    dllist_unrolled_dtor(&list);
+    return EXIT_FAILURE;
+}